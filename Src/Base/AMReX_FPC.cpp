@@ -61,11 +61,14 @@ const int FPC::reverse_float_order_2[]  = { 2, 1, 4, 3 };
 const int FPC::normal_double_order[]    = { 1, 2, 3, 4, 5, 6, 7, 8 };
 const int FPC::reverse_double_order[]   = { 8, 7, 6, 5, 4, 3, 2, 1 };
 const int FPC::reverse_double_order_2[] = { 2, 1, 4, 3, 6, 5, 8, 7 };
+const int FPC::normal_half_order[]      = { 1, 2 };
+const int FPC::reverse_half_order[]     = { 2, 1 };
 //
 // Floating point formats.
 //
 const Long FPC::ieee_float[]  = { 32L,  8L, 23L, 0L, 1L,  9L, 0L,   0x7FL };
 const Long FPC::ieee_double[] = { 64L, 11L, 52L, 0L, 1L, 12L, 0L,  0x3FFL };
+const Long FPC::ieee_half[]   = { 16L,  5L, 10L, 0L, 1L,  6L, 0L,   0xFL };
 //
 // Every copy of the library will have exactly one nativeIntDescriptor,
 // nativeLongDescriptor, and nativeRealDescriptor compiled into it.
@@ -145,6 +148,18 @@ FPC::Native64RealDescriptor ()
     return n64rd;
 }
     
+const
+RealDescriptor&
+FPC::Native16RealDescriptor ()
+{
+#ifdef AMREX_LITTLE_ENDIAN
+    static const RealDescriptor n16rd(ieee_half, reverse_half_order, 2);
+#elif AMREX_BIG_ENDIAN
+    static const RealDescriptor n16rd(ieee_half, normal_half_order, 2);
+#endif
+    return n16rd;
+}
+
 const
 RealDescriptor&
 FPC::Ieee32NormalRealDescriptor ()
@@ -160,4 +175,12 @@ FPC::Ieee64NormalRealDescriptor ()
     static const RealDescriptor i64rd(ieee_double, normal_double_order, 8);
     return i64rd;
 }
+
+const
+RealDescriptor&
+FPC::Ieee16NormalRealDescriptor ()
+{
+    static const RealDescriptor i16rd(ieee_half, normal_half_order, 2);
+    return i16rd;
+}
 }
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <limits>
 #include <cstring>
+#include <cstdint>
 
 #include <AMReX.H>
 #include <AMReX_FabConv.H>
@@ -906,6 +907,302 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast paths for the common IEEE 16, 32 and 64 bit formats.  The loops below
+// work on whole words with shifts and masks so the compiler can vectorize
+// them, instead of moving bit fields one number at a time as PD_fconvert does.
+//
+
+AMREX_FORCE_INLINE
+std::uint16_t
+byte_swap (std::uint16_t x)
+{
+    return static_cast<std::uint16_t>((x << 8) | (x >> 8));
+}
+
+AMREX_FORCE_INLINE
+std::uint32_t
+byte_swap (std::uint32_t x)
+{
+    x = ((x & 0x0000FFFFU) << 16) | ((x & 0xFFFF0000U) >> 16);
+    x = ((x & 0x00FF00FFU) <<  8) | ((x & 0xFF00FF00U) >>  8);
+    return x;
+}
+
+AMREX_FORCE_INLINE
+std::uint64_t
+byte_swap (std::uint64_t x)
+{
+    x = ((x & 0x00000000FFFFFFFFULL) << 32) | ((x & 0xFFFFFFFF00000000ULL) >> 32);
+    x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x & 0xFFFF0000FFFF0000ULL) >> 16);
+    x = ((x & 0x00FF00FF00FF00FFULL) <<  8) | ((x & 0xFF00FF00FF00FF00ULL) >>  8);
+    return x;
+}
+
+//
+// There is no native half precision type, so it is a tag for its bits.
+//
+
+struct ieee_half {};
+
+template <typename T> struct IeeeBits {};
+template <> struct IeeeBits<ieee_half> { using type = std::uint16_t; };
+template <> struct IeeeBits<float>     { using type = std::uint32_t; };
+template <> struct IeeeBits<double>    { using type = std::uint64_t; };
+
+//
+// Round a double to the nearest half, ties to even, with gradual underflow,
+// overflow to infinity, and NaNs kept quiet.
+//
+
+AMREX_FORCE_INLINE
+std::uint16_t
+half_from_double (double x)
+{
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(double));
+    const std::uint16_t sign = static_cast<std::uint16_t>((b >> 48) & 0x8000U);
+    const int           e    = static_cast<int>((b >> 52) & 0x7FF);
+    const std::uint64_t m    = b & 0x000FFFFFFFFFFFFFULL;
+
+    if (e == 0x7FF) {
+        return sign | 0x7C00U | (m ? 0x0200U : 0U);
+    }
+    const int he = e - 1023 + 15;
+    if (he >= 31) {
+        return sign | 0x7C00U;
+    }
+
+    // the half mantissa, including the exponent bits for normal numbers,
+    // and the discarded bits of the double mantissa
+    std::uint64_t h, rem, halfway;
+    if (he > 0) {
+        h       = (std::uint64_t(he) << 10) | (m >> 42);
+        rem     = m & ((1ULL << 42) - 1);
+        halfway = 1ULL << 41;
+    } else if (he >= -10) {
+        const int shift = 43 - he;
+        const std::uint64_t mm = m | (1ULL << 52);
+        h       = mm >> shift;
+        rem     = mm & ((1ULL << shift) - 1);
+        halfway = 1ULL << (shift-1);
+    } else {
+        return sign;
+    }
+    // a carry out of the mantissa correctly increments the exponent, up to
+    // infinity
+    if (rem > halfway || (rem == halfway && (h & 1))) ++h;
+    return sign | static_cast<std::uint16_t>(h);
+}
+
+AMREX_FORCE_INLINE
+double
+double_from_half (std::uint16_t h)
+{
+    const std::uint64_t sign = std::uint64_t(h & 0x8000U) << 48;
+    const int           e    = (h >> 10) & 0x1F;
+    const std::uint64_t m    = h & 0x03FFU;
+    std::uint64_t b;
+    if (e == 0x1F) {
+        b = sign | 0x7FF0000000000000ULL | (m << 42);
+    } else if (e > 0) {
+        b = sign | (std::uint64_t(e - 15 + 1023) << 52) | (m << 42);
+    } else {
+        // zero or denormal, m * 2^-24, which is exact
+        const double x = static_cast<double>(m) * 5.9604644775390625e-08;
+        std::memcpy(&b, &x, sizeof(double));
+        b |= sign;
+    }
+    double x;
+    std::memcpy(&x, &b, sizeof(double));
+    return x;
+}
+
+//
+// Convert the bits of one IEEE number of type TIN to type TOUT.
+//
+
+template <typename TIN, typename TOUT>
+struct ieee_cast
+{
+    using UIN  = typename IeeeBits<TIN>::type;
+    using UOUT = typename IeeeBits<TOUT>::type;
+
+    AMREX_FORCE_INLINE
+    static UOUT apply (UIN ui)
+    {
+        TIN x;
+        std::memcpy(&x, &ui, sizeof(TIN));
+        TOUT y = static_cast<TOUT>(x);
+        UOUT uo;
+        std::memcpy(&uo, &y, sizeof(TOUT));
+        return uo;
+    }
+};
+
+template <typename TIN>
+struct ieee_cast<TIN,ieee_half>
+{
+    using UIN = typename IeeeBits<TIN>::type;
+
+    AMREX_FORCE_INLINE
+    static std::uint16_t apply (UIN ui)
+    {
+        TIN x;
+        std::memcpy(&x, &ui, sizeof(TIN));
+        return half_from_double(static_cast<double>(x));
+    }
+};
+
+template <typename TOUT>
+struct ieee_cast<ieee_half,TOUT>
+{
+    using UOUT = typename IeeeBits<TOUT>::type;
+
+    AMREX_FORCE_INLINE
+    static UOUT apply (std::uint16_t ui)
+    {
+        TOUT y = static_cast<TOUT>(double_from_half(ui));
+        UOUT uo;
+        std::memcpy(&uo, &y, sizeof(TOUT));
+        return uo;
+    }
+};
+
+template <>
+struct ieee_cast<ieee_half,ieee_half>
+{
+    AMREX_FORCE_INLINE
+    static std::uint16_t apply (std::uint16_t ui) { return ui; }
+};
+
+//
+// Convert nitems IEEE numbers of type TIN to type TOUT, reversing the
+// bytes of the input and/or output words as requested.
+//
+
+template <typename TIN, typename TOUT, bool SWAPIN, bool SWAPOUT>
+static
+void
+ieee_convert (void*       out,
+              const void* in,
+              Long        nitems)
+{
+    using UIN  = typename IeeeBits<TIN>::type;
+    using UOUT = typename IeeeBits<TOUT>::type;
+
+    const char* pin  = static_cast<const char*>(in);
+    char*       pout = static_cast<char*>(out);
+
+AMREX_PRAGMA_SIMD
+    for (Long i = 0; i < nitems; ++i)
+    {
+        UIN ui;
+        std::memcpy(&ui, pin + i*sizeof(UIN), sizeof(UIN));
+        if (SWAPIN) ui = byte_swap(ui);
+        UOUT uo = ieee_cast<TIN,TOUT>::apply(ui);
+        if (SWAPOUT) uo = byte_swap(uo);
+        std::memcpy(pout + i*sizeof(UOUT), &uo, sizeof(UOUT));
+    }
+}
+
+//
+// Returns 2, 4 or 8 if rd is IEEE 16, 32 or 64 bit in either the native
+// byte order or the reverse of it, and 0 otherwise.  swapped is set if the
+// bytes are in the reverse of the native order.
+//
+
+static
+int
+ieee_kind (const RealDescriptor& rd,
+           bool&                 swapped)
+{
+    const RealDescriptor* natives[3] = { &FPC::Native16RealDescriptor(),
+                                         &FPC::Native32RealDescriptor(),
+                                         &FPC::Native64RealDescriptor() };
+    for (const RealDescriptor* nrd : natives)
+    {
+        const int nb = nrd->numBytes();
+        if (rd.numBytes() != nb || rd.formatarray() != nrd->formatarray())
+            continue;
+        if (rd.orderarray() == nrd->orderarray())
+        {
+            swapped = false;
+            return nb;
+        }
+        bool reversed = true;
+        for (int i = 0; i < nb; ++i)
+            reversed = reversed && rd.order()[i] == nrd->order()[nb-1-i];
+        if (reversed)
+        {
+            swapped = true;
+            return nb;
+        }
+    }
+    return 0;
+}
+
+template <typename TIN, typename TOUT>
+static
+void
+ieee_convert (void*       out,
+              const void* in,
+              Long        nitems,
+              bool        swapin,
+              bool        swapout)
+{
+    if (swapin) {
+        if (swapout) ieee_convert<TIN,TOUT,true ,true >(out, in, nitems);
+        else         ieee_convert<TIN,TOUT,true ,false>(out, in, nitems);
+    } else {
+        if (swapout) ieee_convert<TIN,TOUT,false,true >(out, in, nitems);
+        else         ieee_convert<TIN,TOUT,false,false>(out, in, nitems);
+    }
+}
+
+template <typename TIN>
+static
+bool
+ieee_convert (void*       out,
+              const void* in,
+              Long        nitems,
+              int         outbytes,
+              bool        swapin,
+              bool        swapout)
+{
+    switch (outbytes) {
+    case 2: ieee_convert<TIN,ieee_half>(out, in, nitems, swapin, swapout); return true;
+    case 4: ieee_convert<TIN,float    >(out, in, nitems, swapin, swapout); return true;
+    case 8: ieee_convert<TIN,double   >(out, in, nitems, swapin, swapout); return true;
+    default: return false;
+    }
+}
+
+//
+// Returns true if the conversion from ird to ord was done by one of the
+// IEEE fast paths.
+//
+
+static
+bool
+PD_ieee_convert (void*                 out,
+                 const void*           in,
+                 Long                  nitems,
+                 const RealDescriptor& ord,
+                 const RealDescriptor& ird)
+{
+    bool swapin = false, swapout = false;
+    const int inbytes  = ieee_kind(ird, swapin);
+    const int outbytes = ieee_kind(ord, swapout);
+
+    switch (inbytes) {
+    case 2: return ieee_convert<ieee_half>(out, in, nitems, outbytes, swapin, swapout);
+    case 4: return ieee_convert<float    >(out, in, nitems, outbytes, swapin, swapout);
+    case 8: return ieee_convert<double   >(out, in, nitems, outbytes, swapin, swapout);
+    default: return false;
+    }
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -924,23 +1221,14 @@ PD_convert (void*                 out,
         BL_ASSERT(int(n) == nitems);
         memcpy(out, in, n*ord.numBytes());
     }
+    else if (boffs == 0 && ! onescmp && PD_ieee_convert(out, in, nitems, ord, ird))
+    {
+        // ---- done by a vectorized IEEE byte swap and/or float <-> double kernel
+    }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
     }
-    else if (ird == FPC::NativeRealDescriptor() && ord == FPC::Native32RealDescriptor()) {
-      auto rIn = static_cast<const char*>(in);
-      auto rOut= static_cast<char*>(out);
-      for(Long i(0); i < nitems; ++i) {
-        Real x;
-        float y;
-        std::memcpy(&x, rIn, sizeof(Real));
-        y = static_cast<float>(x);
-        std::memcpy(rOut, &y, sizeof(float));
-        rOut += sizeof(float);
-        rIn += sizeof(Real);
-      }
-    }
     else
     {
         PD_fconvert(out, in, nitems, boffs, ord.format(), ord.order(),
@@ -988,6 +1276,16 @@ RealDescriptor::convertToNativeFormat (Real*                 out,
 {
 //    BL_PROFILE("RD:convertToNativeFormat_is");
 
+    if (id == FPC::NativeRealDescriptor() && ! bAlwaysFixDenormals)
+    {
+        // ---- the on-disk format is native, read straight into out
+        is.read(reinterpret_cast<char*>(out), nitems*sizeof(Real));
+        if(is.fail()) {
+          amrex::Error("convert(Real*,Long,istream&,RealDescriptor&) failed");
+        }
+        return;
+    }
+
     Long buffSize(std::min(Long(readBufferSize), nitems));
     char *bufr = new char[buffSize * id.numBytes()];
 
@@ -1050,6 +1348,16 @@ RealDescriptor::convertFromNativeFormat (std::ostream&         os,
                                          const RealDescriptor& od)
 {
 //  BL_PROFILE("RD:convertFromNativeFormat_os");
+  if (od == FPC::NativeRealDescriptor())
+  {
+      // ---- the output format is native, write straight from in
+      amrex::StreamRetry sr(os, "RD_cFNF", 4);
+      while(sr.TryOutput()) {
+          os.write(reinterpret_cast<const char*>(in), nitems*sizeof(Real));
+      }
+      return;
+  }
+
   Long nitemsSave(nitems);
   Long buffSize(std::min(Long(writeBufferSize), nitems));
   const Real *inSave(in);
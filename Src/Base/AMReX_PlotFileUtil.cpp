@@ -7,6 +7,7 @@
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_MultiFabUtil_C.H>
 
 #ifdef AMREX_USE_EB
 #include <AMReX_EBFabFactory.H>
@@ -23,6 +24,20 @@
 
 namespace amrex {
 
+const RealDescriptor& PlotFileRealDescriptor (PlotFilePrecision precision)
+{
+    switch (precision) {
+    case PlotFilePrecision::Float64:
+        return FPC::Native64RealDescriptor();
+    case PlotFilePrecision::Float32:
+        return FPC::Native32RealDescriptor();
+    case PlotFilePrecision::Float16:
+        return FPC::Native16RealDescriptor();
+    default:
+        return FPC::NativeRealDescriptor();
+    }
+}
+
 std::string LevelPath (int level, const std::string &levelPrefix)
 {
     return Concatenate(levelPrefix, level, 1);  // e.g., Level_5
@@ -174,7 +189,8 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
                          const std::string &versionName,
                          const std::string &levelPrefix,
                          const std::string &mfPrefix,
-                         const Vector<std::string>& extra_dirs)
+                         const Vector<std::string>& extra_dirs,
+                         PlotFilePrecision precision)
 {
     BL_PROFILE("WriteMultiLevelPlotfile()");
 
@@ -225,7 +241,7 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
 
     for (int level = 0; level <= finest_level; ++level)
     {
-        if (AsyncOut::UseAsyncOut()) {
+        if (AsyncOut::UseAsyncOut() && precision == PlotFilePrecision::Default) {
             VisMF::AsyncWrite(*mf[level],
                               MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
                               true);
@@ -242,7 +258,12 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
             } else {
                 data = mf[level];
             }
-            VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+            if (precision == PlotFilePrecision::Default) {
+                VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+            } else {
+                VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
+                             PlotFileRealDescriptor(precision));
+            }
         }
     }
 }
@@ -351,7 +372,8 @@ WriteSingleLevelPlotfile (const std::string& plotfilename,
                           const std::string &versionName,
                           const std::string &levelPrefix,
                           const std::string &mfPrefix,
-                          const Vector<std::string>& extra_dirs)
+                          const Vector<std::string>& extra_dirs,
+                          PlotFilePrecision precision)
 {
     Vector<const MultiFab*> mfarr(1,&mf);
     Vector<Geometry> geomarr(1,geom);
@@ -359,7 +381,221 @@ WriteSingleLevelPlotfile (const std::string& plotfilename,
     Vector<IntVect> ref_ratio;
 
     WriteMultiLevelPlotfile(plotfilename, 1, mfarr, varnames, geomarr, time,
-                            level_steps, ref_ratio, versionName, levelPrefix, mfPrefix, extra_dirs);
+                            level_steps, ref_ratio, versionName, levelPrefix, mfPrefix, extra_dirs,
+                            precision);
+}
+
+
+PlotFileProduct
+PlotFileProduct::Coarsened (const std::string& name, const IntVect& ratio,
+                            const Vector<std::string>& varnames)
+{
+    PlotFileProduct p;
+    p.kind = Kind::Coarsened;
+    p.name = name;
+    p.varnames = varnames;
+    p.ratio = ratio;
+    return p;
+}
+
+PlotFileProduct
+PlotFileProduct::Slice (const std::string& name, int dir, Real coord,
+                        const Vector<std::string>& varnames)
+{
+    PlotFileProduct p;
+    p.kind = Kind::Slice;
+    p.name = name;
+    p.varnames = varnames;
+    p.dir = dir;
+    p.coord = coord;
+    return p;
+}
+
+PlotFileProduct
+PlotFileProduct::SubBox (const std::string& name, const RealBox& region,
+                         const Vector<std::string>& varnames)
+{
+    PlotFileProduct p;
+    p.kind = Kind::SubBox;
+    p.name = name;
+    p.varnames = varnames;
+    p.region = region;
+    return p;
+}
+
+namespace {
+
+// ---- the coarsened copy of components comps of mf, on the same DistributionMapping
+MultiFab
+CoarsenedProductData (const MultiFab& mf, const Vector<int>& comps, const IntVect& ratio)
+{
+    const BoxArray& ba = mf.boxArray();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ba.coarsenable(ratio),
+        "WriteMultiLevelPlotfileProducts: BoxArray not coarsenable by the product ratio");
+
+    const int ncomp(comps.size());
+    MultiFab crse(amrex::coarsen(ba, ratio), mf.DistributionMap(), ncomp, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(crse, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& carr = crse.array(mfi);
+        Array4<Real const> const& farr = mf.const_array(mfi);
+        for (int n = 0; n < ncomp; ++n) {
+            const int fcomp = comps[n];
+            AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, tbx,
+            {
+                amrex_avgdown(tbx, carr, farr, n, fcomp, 1, ratio);
+            });
+        }
+    }
+    return crse;
+}
+
+// ---- components comps of mf inside region; each piece stays on the rank that owns it
+MultiFab
+SubBoxProductData (const MultiFab& mf, const Vector<int>& comps, const Box& region)
+{
+    const BoxArray& ba = mf.boxArray();
+    const Vector<int>& pmap = mf.DistributionMap().ProcessorMap();
+
+    BoxList bl;
+    Vector<int> subPMap, subToFull;
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        const Box isect = ba[i] & region;
+        if (isect.ok()) {
+            bl.push_back(isect);
+            subPMap.push_back(pmap[i]);
+            subToFull.push_back(i);
+        }
+    }
+
+    const int ncomp(comps.size());
+    MultiFab sub(BoxArray(std::move(bl)), DistributionMapping(std::move(subPMap)), ncomp, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(sub, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        FArrayBox& dfab = sub[mfi];
+        const FArrayBox& sfab = mf[subToFull[mfi.index()]];
+        for (int n = 0; n < ncomp; ++n) {
+            dfab.copy<RunOn::Device>(sfab, bx, comps[n], bx, n, 1);
+        }
+    }
+    return sub;
+}
+
+}
+
+void
+WriteMultiLevelPlotfileProducts (int nlevels,
+                                 const Vector<const MultiFab*> &mf,
+                                 const Vector<std::string> &varnames,
+                                 const Vector<Geometry> &geom,
+                                 Real time,
+                                 const Vector<int> &level_steps,
+                                 const Vector<IntVect> &ref_ratio,
+                                 const Vector<PlotFileProduct> &products,
+                                 PlotFilePrecision precision)
+{
+    BL_PROFILE("WriteMultiLevelPlotfileProducts()");
+
+    BL_ASSERT(nlevels <= mf.size());
+    BL_ASSERT(nlevels <= geom.size());
+    BL_ASSERT(nlevels <= ref_ratio.size()+1);
+    BL_ASSERT(nlevels <= level_steps.size());
+    BL_ASSERT(mf[0]->nComp() == varnames.size());
+
+    for (const PlotFileProduct& product : products)
+    {
+        // ---- the components to write
+        Vector<std::string> pvarnames = product.varnames.empty() ? varnames : product.varnames;
+        Vector<int> comps;
+        for (const std::string& vname : pvarnames) {
+            auto it = std::find(varnames.begin(), varnames.end(), vname);
+            if (it == varnames.end()) {
+                amrex::Abort("WriteMultiLevelPlotfileProducts: no variable named " + vname
+                             + " for product " + product.name);
+            }
+            comps.push_back(static_cast<int>(it - varnames.begin()));
+        }
+
+        Vector<MultiFab> pmf;
+        Vector<Geometry> pgeom;
+
+        if (product.kind == PlotFileProduct::Kind::Coarsened)
+        {
+            for (int level = 0; level < nlevels; ++level) {
+                const Box& domain = geom[level].Domain();
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(domain.coarsenable(product.ratio),
+                    "WriteMultiLevelPlotfileProducts: domain not coarsenable by the product ratio");
+                pmf.push_back(CoarsenedProductData(*mf[level], comps, product.ratio));
+                pgeom.emplace_back(amrex::coarsen(domain, product.ratio), geom[level].ProbDomain(),
+                                   geom[level].Coord(), geom[level].isPeriodic());
+            }
+        }
+        else
+        {
+            // ---- the level-0 cells making up the product
+            const Box& domain0 = geom[0].Domain();
+            Box region0;
+            if (product.kind == PlotFileProduct::Kind::Slice) {
+                const int dir = product.dir;
+                BL_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+                const int islice = static_cast<int>(std::floor((product.coord - geom[0].ProbLo(dir))
+                                                               * geom[0].InvCellSize(dir)));
+                region0 = domain0;
+                region0.setSmall(dir, islice);
+                region0.setBig(dir, islice);
+            } else {
+                IntVect lo, hi;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    lo[d] = static_cast<int>(std::floor((product.region.lo(d) - geom[0].ProbLo(d))
+                                                        * geom[0].InvCellSize(d)));
+                    hi[d] = static_cast<int>(std::ceil((product.region.hi(d) - geom[0].ProbLo(d))
+                                                       * geom[0].InvCellSize(d))) - 1;
+                }
+                region0 = Box(lo, hi);
+            }
+            region0 &= domain0;
+            if ( ! region0.ok()) {
+                amrex::Abort("WriteMultiLevelPlotfileProducts: product " + product.name
+                             + " does not intersect the domain");
+            }
+
+            RealBox prb;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                prb.setLo(d, geom[0].ProbLo(d) + region0.smallEnd(d) * geom[0].CellSize(d));
+                prb.setHi(d, geom[0].ProbLo(d) + (region0.bigEnd(d)+1) * geom[0].CellSize(d));
+            }
+            const Array<int,AMREX_SPACEDIM> notPeriodic{AMREX_D_DECL(0,0,0)};
+
+            Box region = region0;
+            for (int level = 0; level < nlevels; ++level) {
+                if (level > 0) {
+                    region.refine(ref_ratio[level-1]);
+                }
+                const Box pdomain = region & geom[level].Domain();
+                MultiFab sub = SubBoxProductData(*mf[level], comps, pdomain);
+                if (sub.boxArray().empty()) {
+                    break;  // ---- no finer data in the product region
+                }
+                pmf.push_back(std::move(sub));
+                pgeom.emplace_back(pdomain, prb, geom[level].Coord(), notPeriodic);
+            }
+        }
+
+        const int pnlevels = pmf.size();
+        WriteMultiLevelPlotfile(product.name, pnlevels, GetVecOfConstPtrs(pmf), pvarnames,
+                                pgeom, time, level_steps, ref_ratio, "HyperCLaw-V1.1",
+                                "Level_", "Cell", Vector<std::string>(), precision);
+    }
 }
 
 
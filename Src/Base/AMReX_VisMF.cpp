@@ -10,6 +10,14 @@
 #include <array>
 #include <memory>
 #include <numeric>
+#include <tuple>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <iomanip>
 
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
@@ -19,11 +27,14 @@
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
 #include <AMReX_AsyncOut.H>
+#include <AMReX_FileSystem.H>
 
 namespace amrex {
 
 static const char *TheMultiFabHdrFileSuffix = "_H";
 static const char *FabFileSuffix = "_D_";
+static const char *FabHashFileSuffix = "_FH";
+static const char *FabHashName = "SHA-256";
 static const char *TheFabOnDiskPrefix = "FabOnDisk:";
 
 std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
@@ -38,7 +49,9 @@ bool VisMF::checkFilePositions(false);
 bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
+bool VisMF::usePrefetchReads(false);
 bool VisMF::allowSparseWrites(true);
+int  VisMF::nPrefetchThreads(4);
 
 Long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -51,6 +64,193 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // The RealDescriptor matching the current fab.format, or nullptr
+    // if the format is not a binary one.
+    //
+    const RealDescriptor* FormatRealDescriptor ()
+    {
+        if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+          return &FPC::NativeRealDescriptor();
+        } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
+          return &FPC::Native32RealDescriptor();
+        } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
+          return &FPC::Ieee32NormalRealDescriptor();
+        }
+        return nullptr;
+    }
+
+    //
+    // SHA-256, used to decide whether a fab written by WriteDelta is the
+    // same as the one in the prior write.  A collision would silently put
+    // stale data in a checkpoint, so a cryptographic digest is used rather
+    // than a fast one.
+    //
+    class Sha256
+    {
+    public:
+        static constexpr int DigestWords = 4;  // in 64-bit words
+        using Digest = std::array<std::uint64_t,DigestWords>;
+
+        void update (const void* data, std::size_t n)
+        {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            m_total += n;
+            if(m_buflen > 0) {
+              const std::size_t k(std::min(n, std::size_t(64) - m_buflen));
+              std::memcpy(m_buf + m_buflen, p, k);
+              m_buflen += k;
+              p += k;
+              n -= k;
+              if(m_buflen == 64) {
+                compress(m_buf);
+                m_buflen = 0;
+              }
+            }
+            for( ; n >= 64; p += 64, n -= 64) {
+              compress(p);
+            }
+            std::memcpy(m_buf, p, n);
+            m_buflen += n;
+        }
+
+        Digest digest ()
+        {
+            const std::uint64_t nbits(m_total * 8);
+            const unsigned char pad(0x80), zero(0);
+            update(&pad, 1);
+            while(m_buflen != 56) {
+              update(&zero, 1);
+            }
+            unsigned char len[8];
+            for(int i(0); i < 8; ++i) {
+              len[i] = static_cast<unsigned char>(nbits >> (56 - 8*i));
+            }
+            update(len, 8);
+
+            Digest d;
+            for(int i(0); i < DigestWords; ++i) {
+              d[i] = (std::uint64_t(m_h[2*i]) << 32) | m_h[2*i+1];
+            }
+            return d;
+        }
+
+    private:
+        std::uint32_t m_h[8] = { 0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+                                 0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U };
+        unsigned char m_buf[64];
+        std::size_t   m_buflen = 0;
+        std::uint64_t m_total = 0;
+
+        static std::uint32_t rotr (std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+        void compress (const unsigned char* block)
+        {
+            static const std::uint32_t k[64] = {
+              0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+              0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+              0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+              0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+              0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+              0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+              0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+              0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U };
+
+            std::uint32_t w[64];
+            for(int i(0); i < 16; ++i) {
+              w[i] = (std::uint32_t(block[4*i]) << 24) | (std::uint32_t(block[4*i+1]) << 16) |
+                     (std::uint32_t(block[4*i+2]) << 8) | std::uint32_t(block[4*i+3]);
+            }
+            for(int i(16); i < 64; ++i) {
+              const std::uint32_t s0(rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3));
+              const std::uint32_t s1(rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10));
+              w[i] = w[i-16] + s0 + w[i-7] + s1;
+            }
+
+            std::uint32_t a(m_h[0]), b(m_h[1]), c(m_h[2]), d(m_h[3]);
+            std::uint32_t e(m_h[4]), f(m_h[5]), g(m_h[6]), h(m_h[7]);
+            for(int i(0); i < 64; ++i) {
+              const std::uint32_t S1(rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25));
+              const std::uint32_t ch((e & f) ^ (~e & g));
+              const std::uint32_t t1(h + S1 + ch + k[i] + w[i]);
+              const std::uint32_t S0(rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22));
+              const std::uint32_t maj((a & b) ^ (a & c) ^ (b & c));
+              const std::uint32_t t2(S0 + maj);
+              h = g; g = f; f = e; e = d + t1;
+              d = c; c = b; b = a; a = t1 + t2;
+            }
+            m_h[0] += a; m_h[1] += b; m_h[2] += c; m_h[3] += d;
+            m_h[4] += e; m_h[5] += f; m_h[6] += g; m_h[7] += h;
+        }
+    };
+
+    //
+    // The SHA-256 digest of the fab's box, number of components and data.
+    //
+    Sha256::Digest HashFab (const FArrayBox& fab)
+    {
+        Sha256 sha;
+        for(int d(0); d < AMREX_SPACEDIM; ++d) {
+          const std::int64_t lohi[2] = { fab.box().smallEnd(d), fab.box().bigEnd(d) };
+          sha.update(lohi, sizeof(lohi));
+        }
+        const std::int64_t nc(fab.nComp());
+        sha.update(&nc, sizeof(nc));
+        sha.update(fab.dataPtr(), fab.nBytes());
+        return sha.digest();
+    }
+
+    //
+    // Split a path into its components, resolving "." and ".." and
+    // making it absolute with respect to the current directory.
+    //
+    std::vector<std::string> PathComponents (const std::string& path)
+    {
+        std::string full(path);
+        if(full.empty() || full[0] != '/') {
+          full = FileSystem::CurrentPath() + "/" + full;
+        }
+        std::vector<std::string> comps;
+        std::istringstream iss(full);
+        std::string c;
+        while(std::getline(iss, c, '/')) {
+          if(c.empty() || c == ".") {
+            continue;
+          } else if(c == "..") {
+            if( ! comps.empty()) {
+              comps.pop_back();
+            }
+          } else {
+            comps.push_back(c);
+          }
+        }
+        return comps;
+    }
+
+    //
+    // The name of file relative to the directory dir.
+    //
+    std::string RelativePath (const std::string& dir, const std::string& file)
+    {
+        const std::vector<std::string> d(PathComponents(dir.empty() ? "." : dir));
+        const std::vector<std::string> f(PathComponents(file));
+        std::size_t common(0);
+        while(common < d.size() && common + 1 < f.size() && d[common] == f[common]) {
+          ++common;
+        }
+        std::string rel;
+        for(std::size_t i(common); i < d.size(); ++i) {
+          rel += "../";
+        }
+        for(std::size_t i(common); i < f.size(); ++i) {
+          rel += f[i];
+          if(i + 1 < f.size()) {
+            rel += '/';
+          }
+        }
+        return rel;
+    }
 }
 
 void
@@ -85,6 +285,10 @@ VisMF::Initialize ()
     pp.query("usepersistentifstreams", usePersistentIFStreams);
     pp.query("usesynchronousreads", useSynchronousReads);
     pp.query("usedynamicsetselection", useDynamicSetSelection);
+    pp.query("useprefetchreads", usePrefetchReads);
+    if(pp.query("nprefetchthreads", nPrefetchThreads)) {
+      VisMF::SetNPrefetchThreads(nPrefetchThreads);
+    }
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
 
@@ -308,13 +512,7 @@ operator<< (std::ostream        &os,
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
        hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
     {
-      if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
-        os << FPC::NativeRealDescriptor() << '\n';
-      } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
-        os << FPC::Native32RealDescriptor() << '\n';
-      } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
-        os << FPC::Ieee32NormalRealDescriptor() << '\n';
-      }
+      os << hd.m_writtenRD << '\n';
     }
 
     os.flags(oflags);
@@ -660,6 +858,9 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
 {
 //    BL_PROFILE("VisMF::Header");
 
+    const RealDescriptor *formatRD = FormatRealDescriptor();
+    m_writtenRD = formatRD ? *formatRD : FPC::NativeRealDescriptor();
+
     if(version == NoFabHeader_v1) {
       m_min.clear();
       m_max.clear();
@@ -943,6 +1144,33 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
               const std::string& mf_name,
               VisMF::How         how,
               bool               set_ghost)
+{
+    const RealDescriptor *formatRD = FormatRealDescriptor();
+    if(formatRD == nullptr) {
+      Abort("VisMF::Write unable to execute with the current fab.format setting.  Use NATIVE, NATIVE_32 or IEEE_32");
+    }
+    return VisMF::Write(mf, mf_name, *formatRD, how, set_ghost);
+}
+
+
+Long
+VisMF::Write (const FabArray<FArrayBox>&    mf,
+              const std::string&    mf_name,
+              const RealDescriptor& whichRD,
+              VisMF::How            how,
+              bool                  set_ghost)
+{
+    return VisMF::WriteDoit(mf, mf_name, whichRD, how, set_ghost, Vector<FabOnDisk>());
+}
+
+
+Long
+VisMF::WriteDoit (const FabArray<FArrayBox>&    mf,
+                  const std::string&       mf_name,
+                  const RealDescriptor&    whichRD,
+                  VisMF::How               how,
+                  bool                     set_ghost,
+                  const Vector<FabOnDisk>& reusedFod)
 {
     BL_PROFILE("VisMF::Write(FabArray)");
     BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
@@ -950,18 +1178,7 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     // ---- add stream retry
     // ---- add stream buffer (to nfiles)
-    RealDescriptor *whichRD = nullptr;
-    if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
-      whichRD = FPC::NativeRealDescriptor().clone();
-    } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
-      whichRD = FPC::Native32RealDescriptor().clone();
-    } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
-      whichRD = FPC::Ieee32NormalRealDescriptor().clone();
-    } else {
-      whichRD = FPC::NativeRealDescriptor().clone(); // to quiet clang static analyzer
-      Abort("VisMF::Write unable to execute with the current fab.format setting.  Use NATIVE, NATIVE_32 or IEEE_32");
-    }
-    bool doConvert(*whichRD != FPC::NativeRealDescriptor());
+    bool doConvert(whichRD != FPC::NativeRealDescriptor());
 
     if(set_ghost && mf.nGrowVect() != 0) {
         FabArray<FArrayBox>* the_mf = const_cast<FabArray<FArrayBox>*>(&mf);
@@ -1012,6 +1229,12 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     Long bytesWritten(0);
     bool calcMinMax(false);
     VisMF::Header hdr(mf, how, currentVersion, calcMinMax);
+    hdr.m_writtenRD = whichRD;
+
+    // ---- fabs with a reusedFod entry are already on disk and are not written again
+    auto isReused = [&reusedFod] (int i) -> bool {
+        return ! reusedFod.empty() && ! reusedFod[i].m_name.empty();
+    };
 
     std::string filePrefix(mf_name + FabFileSuffix);
 
@@ -1026,10 +1249,14 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
         // ---- find the total number of bytes including fab headers if needed
-        const FABio &fio = FArrayBox::getFABio();
-        int whichRDBytes(whichRD->numBytes()), nFABs(0);
+        const FABio_binary fio_binary(whichRD.clone());
+        const FABio &fio = fio_binary;
+        int whichRDBytes(whichRD.numBytes()), nFABs(0);
         Long writeDataItems(0), writeDataSize(0);
         for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            if(isReused(mfi.index())) {
+                continue;
+            }
             const FArrayBox &fab = mf[mfi];
             if(oldHeader) {
                 std::stringstream hss;
@@ -1053,6 +1280,9 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         if(canCombineFABs) {
             Long writePosition(0);
             for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                if(isReused(mfi.index())) {
+                    continue;
+                }
                 int hLength(0);
                 const FArrayBox &fab = mf[mfi];
                 writeDataItems = fab.box().numPts() * mf.nComp();
@@ -1068,7 +1298,7 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
                 if(doConvert) {
                     RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr + hLength),
                                                             writeDataItems,
-                                                            fab.dataPtr(), *whichRD);
+                                                            fab.dataPtr(), whichRD);
                 } else {    // ---- copy from the fab
                     memcpy(afPtr + hLength, fab.dataPtr(), writeDataSize);
                 }
@@ -1080,6 +1310,9 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
         } else {    // ---- write fabs individually
             for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                if(isReused(mfi.index())) {
+                    continue;
+                }
                 int hLength(0);
                 const FArrayBox &fab = mf[mfi];
                 writeDataItems = fab.box().numPts() * mf.nComp();
@@ -1096,7 +1329,7 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
                     char *cDataPtr = new char[writeDataSize];
                     RealDescriptor::convertFromNativeFormat(static_cast<void *> (cDataPtr),
                                                             writeDataItems,
-                                                            fab.dataPtr(), *whichRD);
+                                                            fab.dataPtr(), whichRD);
                     nfi.Stream().write(cDataPtr, writeDataSize);
                     nfi.Stream().flush();
                     delete [] cDataPtr;
@@ -1123,11 +1356,145 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
 
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+                       ParallelDescriptor::Communicator(),
+                       reusedFod.empty() ? nullptr : &reusedFod);
+
+    if(ParallelDescriptor::MyProc() == coordinatorProc) {
+        for(int i(0); i < reusedFod.size(); ++i) {
+            if(isReused(i)) {
+                hdr.m_fod[i] = reusedFod[i];
+            }
+        }
+    }
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
-    delete whichRD;
+    return bytesWritten;
+}
+
+
+Long
+VisMF::WriteDelta (const FabArray<FArrayBox>& mf,
+                   const std::string&         mf_name,
+                   const std::string&         prior_name,
+                   VisMF::How                 how)
+{
+    BL_PROFILE("VisMF::WriteDelta()");
+    BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
+
+    const RealDescriptor *formatRD = FormatRealDescriptor();
+    if(formatRD == nullptr) {
+      Abort("VisMF::WriteDelta unable to execute with the current fab.format setting.  Use NATIVE, NATIVE_32 or IEEE_32");
+    }
+
+    amrex::prefetchToHost(mf);
+
+    const int nFabs(mf.size());
+
+    // ---- hash the local fabs and share the digests and sizes so every rank
+    // ---- sees all of them
+    const int nWords(Sha256::DigestWords);
+    Vector<Long> fabHash(nFabs*(nWords+1), 0);
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+      const Sha256::Digest h(HashFab(mf[mfi]));
+      Long* p = fabHash.dataPtr() + mfi.index()*(nWords+1);
+      std::memcpy(p, h.data(), sizeof(h));
+      p[nWords] = mf[mfi].nBytes();
+    }
+    ParallelAllReduce::Sum(fabHash.dataPtr(), fabHash.size(), ParallelDescriptor::Communicator());
+
+    if (Gpu::inLaunchRegion()) {
+      amrex::prefetchToDevice(mf);
+    }
+
+    // ---- compare with the prior write, if it exists and has the same layout
+    Vector<FabOnDisk> reusedFod;
+    int nReused(0);
+    if( ! prior_name.empty()) {
+      Vector<char> priorHdrChars, priorHashChars;
+      ParallelDescriptor::ReadAndBcastFile(prior_name + TheMultiFabHdrFileSuffix,
+                                           priorHdrChars, false);
+      ParallelDescriptor::ReadAndBcastFile(prior_name + FabHashFileSuffix,
+                                           priorHashChars, false);
+
+      if( ! priorHdrChars.empty() && ! priorHashChars.empty()) {
+        VisMF::Header priorHdr;
+        std::istringstream hdrIS(priorHdrChars.dataPtr());
+        hdrIS >> priorHdr;
+
+        std::istringstream hashIS(priorHashChars.dataPtr());
+        std::string digestName;
+        int nPriorFabs(-1);
+        RealDescriptor priorRD;
+        hashIS >> digestName;
+        if(digestName == FabHashName) {
+          hashIS >> nPriorFabs >> priorRD;
+        }
+
+        if(nPriorFabs == nFabs && priorRD == *formatRD &&
+           priorHdr.m_vers  == currentVersion &&
+           priorHdr.m_ncomp == mf.nComp() &&
+           priorHdr.m_ngrow == mf.nGrowVect() &&
+           priorHdr.m_ba    == mf.boxArray())
+        {
+          const std::string priorDir(VisMF::DirName(prior_name));
+          const std::string newDir(VisMF::DirName(mf_name));
+          reusedFod.resize(nFabs);
+          for(int i(0); i < nFabs; ++i) {
+            const Long* p = fabHash.dataPtr() + i*(nWords+1);
+            Long priorBytes(-1);
+            bool same(true);
+            hashIS >> std::dec >> priorBytes >> std::hex;
+            for(int w(0); w < nWords; ++w) {
+              std::uint64_t priorWord(0), word(0);
+              hashIS >> priorWord;
+              std::memcpy(&word, p + w, sizeof(word));
+              same = same && priorWord == word;
+            }
+            if( ! hashIS) {
+              amrex::Abort("VisMF::WriteDelta:  corrupt hash file for " + prior_name);
+            }
+            if(same && priorBytes == p[nWords]) {
+              reusedFod[i].m_name = RelativePath(newDir, priorDir + priorHdr.m_fod[i].m_name);
+              reusedFod[i].m_head = priorHdr.m_fod[i].m_head;
+              ++nReused;
+            }
+          }
+        }
+      }
+    }
+
+    if(verbose) {
+      amrex::Print() << "VisMF::WriteDelta:  " << mf_name << ":  reusing " << nReused
+                     << " of " << nFabs << " fabs from " << prior_name << '\n';
+    }
+
+    Long bytesWritten(VisMF::WriteDoit(mf, mf_name, *formatRD, how, false, reusedFod));
+
+    // ---- record the sizes and digests for the next delta
+    if(ParallelDescriptor::IOProcessor()) {
+      std::string hashFileName(mf_name + FabHashFileSuffix);
+      std::ofstream hashFile(hashFileName.c_str(), std::ios::out | std::ios::trunc);
+      if( ! hashFile.good()) {
+        amrex::FileOpenFailed(hashFileName);
+      }
+      hashFile << FabHashName << '\n' << nFabs << '\n' << *formatRD << '\n';
+      hashFile.fill('0');
+      for(int i(0); i < nFabs; ++i) {
+        const Long* p = fabHash.dataPtr() + i*(nWords+1);
+        hashFile << std::dec << p[nWords] << std::hex;
+        for(int w(0); w < nWords; ++w) {
+          std::uint64_t word;
+          std::memcpy(&word, p + w, sizeof(word));
+          hashFile << ' ' << std::setw(16) << word;
+        }
+        hashFile << '\n';
+      }
+      hashFile.flush();
+      if( ! hashFile.good()) {
+        amrex::Abort("VisMF::WriteDelta: problem writing hash file: " + hashFileName);
+      }
+    }
 
     return bytesWritten;
 }
@@ -1172,7 +1539,8 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 		    const std::string &filePrefix,
                     VisMF::Header &hdr,
 		    VisMF::Header::Version /*whichVersion*/,
-		    NFilesIter &nfi, MPI_Comm comm)
+		    NFilesIter &nfi, MPI_Comm comm,
+                    const Vector<FabOnDisk> *reusedFod)
 {
 //    BL_PROFILE("VisMF::FindOffsets");
 
@@ -1253,16 +1621,9 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 
     } else {    // ---- calculate offsets
 
-      RealDescriptor *whichRD = nullptr;
-      if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
-        whichRD = FPC::NativeRealDescriptor().clone();
-      } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
-        whichRD = FPC::Native32RealDescriptor().clone();
-      } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
-        whichRD = FPC::Ieee32NormalRealDescriptor().clone();
-      }
-      const FABio &fio = FArrayBox::getFABio();
-      int whichRDBytes(whichRD->numBytes());
+      const FABio_binary fio_binary(hdr.m_writtenRD.clone());
+      const FABio &fio = fio_binary;
+      int whichRDBytes(hdr.m_writtenRD.numBytes());
       int nComps(mf.nComp());
 
       if(myProc == coordinatorProc) {   // ---- calculate offsets
@@ -1286,6 +1647,9 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 
 	std::map<int, Vector<int> > rankBoxOrder;  // ---- [rank, boxarray index array]
 	for(int i(0); i < mfBA.size(); ++i) {
+	  if(reusedFod != nullptr && ! (*reusedFod)[i].m_name.empty()) {
+	    continue;  // ---- not written to this file set
+	  }
 	  rankBoxOrder[mfDM[i]].push_back(i);
 	}
 
@@ -1328,7 +1692,6 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	  }
 	}
       }
-      delete whichRD;
     }
 }
 
@@ -1342,6 +1705,7 @@ VisMF::RemoveFiles(const std::string &mf_name, bool a_verbose)
         amrex::Print() << "---- removing:  " << MFHdrFileName << std::endl;
       }
       int retVal(std::remove(MFHdrFileName.c_str()));
+      std::remove((mf_name + FabHashFileSuffix).c_str());  // ---- only written by WriteDelta
       if(a_verbose) {
         if(retVal != 0) {
           amrex::Print() << "---- error removing:  " << MFHdrFileName << "  errno = "
@@ -1549,7 +1913,11 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  if(noFabHeader && usePrefetchReads) {
+
+    VisMF::ReadPrefetch(mf, mf_name, hdr);
+
+  } else if(noFabHeader && useSynchronousReads) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -1914,8 +2282,12 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   }
 
 #else
-    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-      VisMF::readFAB(mf,mfi.index(), mf_name, hdr);
+    if(NoFabHeader(hdr) && usePrefetchReads) {
+      VisMF::ReadPrefetch(mf, mf_name, hdr);
+    } else {
+      for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        VisMF::readFAB(mf,mfi.index(), mf_name, hdr);
+      }
     }
 #endif
 
@@ -1944,6 +2316,164 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::ReadPrefetch (FabArray<FArrayBox> &mf,
+                     const std::string   &mf_name,
+                     const VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::ReadPrefetch()");
+
+    const int nBoxes(hdr.m_ba.size());
+    const int nProcs(ParallelDescriptor::NProcs());
+    const int myProc(ParallelDescriptor::MyProc());
+    const Long rdBytes(hdr.m_writtenRD.numBytes());
+    const bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
+
+    // ---- order the fabs as they are laid out on disk
+    Vector<int> fileOrder(nBoxes);
+    std::iota(fileOrder.begin(), fileOrder.end(), 0);
+    std::sort(fileOrder.begin(), fileOrder.end(), [&hdr] (int a, int b)
+              { return std::tie(hdr.m_fod[a].m_name, hdr.m_fod[a].m_head)
+                     < std::tie(hdr.m_fod[b].m_name, hdr.m_fod[b].m_head); });
+
+    Vector<Long> fabBytes(nBoxes);
+    Long totalBytes(0);
+    for(int i(0); i < nBoxes; ++i) {
+      fabBytes[i] = amrex::grow(hdr.m_ba[i], hdr.m_ngrow).numPts() * hdr.m_ncomp * rdBytes;
+      totalBytes += fabBytes[i];
+    }
+
+    // ---- cut the file order into nProcs pieces with about the same number
+    // ---- of bytes so each rank reads one contiguous range
+    Vector<int> readRanks(nBoxes);
+    Long runningBytes(0);
+    for(int i : fileOrder) {
+      double frac(static_cast<double>(runningBytes) / std::max<Long>(totalBytes, 1));
+      readRanks[i] = std::min(nProcs - 1, static_cast<int>(frac * nProcs));
+      runningBytes += fabBytes[i];
+    }
+
+    DistributionMapping dmRead(std::move(readRanks));
+    bool inReadOrder(mf.DistributionMap() == dmRead);
+    FabArray<FArrayBox> faRead;
+    if( ! inReadOrder) {
+      faRead.define(mf.boxArray(), dmRead, hdr.m_ncomp, hdr.m_ngrow, MFInfo(), mf.Factory());
+    }
+    FabArray<FArrayBox> &whichFA = inReadOrder ? mf : faRead;
+
+    Vector<int> myFabs;
+    for(int i : fileOrder) {
+      if(dmRead[i] == myProc) {
+        myFabs.push_back(i);
+      }
+    }
+    const int nMyFabs(myFabs.size());
+
+    Vector<Real *> dstPtrs(nMyFabs);
+    Vector<Long> nItems(nMyFabs);
+    for(int n(0); n < nMyFabs; ++n) {
+      FArrayBox &fab = whichFA[myFabs[n]];
+      dstPtrs[n] = fab.dataPtr();
+      nItems[n]  = fab.box().numPts() * fab.nComp();
+    }
+
+    const int nThreads(std::min(nPrefetchThreads, nMyFabs));
+    const int maxInFlight(2 * nThreads);   // ---- bounds the buffered bytes
+    std::atomic<int> nextFab(0);
+    std::mutex qMutex;
+    std::condition_variable qCond;
+    std::deque<std::pair<int, Vector<char> > > readyQueue;   // ---- [myFabs index, raw data]
+    int nInFlight(0);
+
+    auto reader = [&] ()
+    {
+      std::ifstream ifs;
+      std::string openFile, fullName;
+      VisMF::IO_Buffer io_buffer(setBuf ? ioBufferSize : 0);
+      auto checkRead = [&] (std::streamsize nBytes)
+      {
+        if( ! ifs.good() || ifs.gcount() != nBytes) {
+          amrex::Abort("VisMF::ReadPrefetch:  short read of " + fullName);
+        }
+      };
+      for(int n(nextFab++); n < nMyFabs; n = nextFab++) {
+        const VisMF::FabOnDisk &fod = hdr.m_fod[myFabs[n]];
+        if(fod.m_name != openFile) {
+          if(ifs.is_open()) {
+            ifs.close();
+          }
+          openFile = fod.m_name;
+          fullName = VisMF::DirName(mf_name) + openFile;
+          if(setBuf) {
+            ifs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+          }
+          ifs.open(fullName.c_str(), std::ios::in | std::ios::binary);
+          if( ! ifs.good()) {
+            amrex::FileOpenFailed(fullName);
+          }
+        }
+        ifs.seekg(fod.m_head, std::ios::beg);
+
+        if(doConvert) {
+          {
+            std::unique_lock<std::mutex> lock(qMutex);
+            qCond.wait(lock, [&] { return nInFlight < maxInFlight; });
+            ++nInFlight;
+          }
+          Vector<char> rawData(nItems[n] * rdBytes);
+          ifs.read(rawData.dataPtr(), rawData.size());
+          checkRead(rawData.size());
+          {
+            std::lock_guard<std::mutex> lock(qMutex);
+            readyQueue.emplace_back(n, std::move(rawData));
+          }
+          qCond.notify_all();
+        } else {
+          ifs.read((char *) dstPtrs[n], nItems[n] * rdBytes);
+          checkRead(nItems[n] * rdBytes);
+        }
+      }
+    };
+
+    Vector<std::thread> readers;
+    for(int t(0); t < nThreads; ++t) {
+      readers.emplace_back(reader);
+    }
+
+    if(doConvert) {   // ---- convert on this thread while the readers keep reading
+      for(int nConverted(0); nConverted < nMyFabs; ++nConverted) {
+        std::pair<int, Vector<char> > ready;
+        {
+          std::unique_lock<std::mutex> lock(qMutex);
+          qCond.wait(lock, [&] { return ! readyQueue.empty(); });
+          ready = std::move(readyQueue.front());
+          readyQueue.pop_front();
+        }
+        RealDescriptor::convertToNativeFormat(dstPtrs[ready.first], nItems[ready.first],
+                                              ready.second.dataPtr(), hdr.m_writtenRD);
+        {
+          std::lock_guard<std::mutex> lock(qMutex);
+          --nInFlight;
+        }
+        qCond.notify_all();
+      }
+    }
+
+    for(auto &t : readers) {
+      t.join();
+    }
+
+    if( ! inReadOrder) {
+      mf.Redistribute(faRead, 0, 0, hdr.m_ncomp, hdr.m_ngrow);
+    }
+
+    if(verbose && myProc == ParallelDescriptor::IOProcessorNumber()) {
+      amrex::AllPrint() << "VisMF::ReadPrefetch:  nThreads = " << nThreads
+                        << "  inReadOrder = " << inReadOrder << std::endl;
+    }
+}
+
+
 bool
 VisMF::Exist (const std::string& mf_name)
 {
@@ -2228,6 +2758,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
     RealDescriptor const& whichRD = FPC::NativeRealDescriptor();
 
     auto hdr = std::make_shared<VisMF::Header>(mf, VisMF::NFiles, VisMF::Header::Version_v1, false);
+    hdr->m_writtenRD = whichRD;
     if (valid_cells_only) hdr->m_ngrow = IntVect(0);
 
     constexpr int sizeof_int64_over_real = sizeof(int64_t) / sizeof(Real);
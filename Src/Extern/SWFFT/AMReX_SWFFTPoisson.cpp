@@ -0,0 +1,192 @@
+#include <AMReX_SWFFTPoisson.H>
+#include <AMReX_ParallelContext.H>
+
+// These are for SWFFT
+#include <Distribution.H>
+#include <Dfft.H>
+
+#include <cmath>
+
+namespace amrex {
+
+namespace {
+
+// SWFFT orders the directions as (z,y,x), so that the block of a rank,
+// which AMReX stores with x fastest, is a C array of size n[0]*n[1]*n[2].
+
+// Number of blocks in each direction, in SWFFT order.  This is what
+// SWFFT itself would choose for a default decomposition.
+void block_counts (int nprocs, int nb[3])
+{
+    nb[0] = nb[1] = nb[2] = 0;
+    MPI_Dims_create(nprocs, 3, nb);
+}
+
+// The pencils of SWFFT split two directions over a 2D process grid, which
+// must refine the blocks.  This checks the layouts distribution_init tries
+// first, so that unsupported sizes fall back instead of aborting there.
+bool pencils_fit (const int n[3], const int nb[3], int nprocs)
+{
+    int p[2] = {0, 0};
+    MPI_Dims_create(nprocs, 2, p);
+    for (int axis = 0; axis < 3; ++axis) {
+        const int d0 = (axis == 0) ? 1 : 0;
+        const int d1 = (axis == 2) ? 1 : 2;
+        bool ok = false;
+        for (int swap = 0; swap < 2 && !ok; ++swap) {
+            const int p0 = p[swap];
+            const int p1 = p[1-swap];
+            ok = n[d0] % p0 == 0 && n[d1] % p1 == 0
+                && p0 % nb[d0] == 0 && p1 % nb[d1] == 0;
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+}
+
+bool
+SWFFTPoisson::isSupported (const Geometry& a_geom, int nprocs)
+{
+    if (!a_geom.isAllPeriodic() || !a_geom.IsCartesian()) return false;
+
+    const Box& domain = a_geom.Domain();
+    const int n[3] = {domain.length(2), domain.length(1), domain.length(0)};
+    int nb[3];
+    block_counts(nprocs, nb);
+    for (int d = 0; d < 3; ++d) {
+        // distribution_init also asserts that n[0] is divisible by all of them
+        if (n[d] % nb[d] != 0 || n[0] % nb[d] != 0) return false;
+    }
+    return pencils_fit(n, nb, nprocs);
+}
+
+SWFFTPoisson::SWFFTPoisson (const Geometry& a_geom)
+    : m_geom(a_geom)
+{
+    BL_PROFILE("SWFFTPoisson::SWFFTPoisson()");
+
+    const int nprocs = ParallelContext::NProcsSub();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(isSupported(m_geom, nprocs),
+                                     "SWFFTPoisson: domain not supported");
+
+    const Box& domain = m_geom.Domain();
+    const int n[3] = {domain.length(2), domain.length(1), domain.length(0)};
+    int nb[3];
+    block_counts(nprocs, nb);
+    const IntVect block_size(n[2]/nb[2], n[1]/nb[1], n[0]/nb[0]);
+
+    // SWFFT puts rank r at block (r/(nb[1]*nb[2]), (r/nb[2])%nb[1], r%nb[2]),
+    // so the z blocks are the slowest
+    BoxList bl;
+    Vector<int> pmap;
+    bl.reserve(nprocs);
+    pmap.reserve(nprocs);
+    for (int k = 0; k < nb[0]; ++k) {
+        for (int j = 0; j < nb[1]; ++j) {
+            for (int i = 0; i < nb[2]; ++i) {
+                const IntVect lo = domain.smallEnd() + IntVect(i,j,k)*block_size;
+                bl.push_back(Box(lo, lo+block_size-1));
+                pmap.push_back(ParallelContext::local_to_global_rank(pmap.size()));
+            }
+        }
+    }
+    m_ba.define(std::move(bl));
+    m_dm.define(std::move(pmap));
+    m_phi.define(m_ba, m_dm, 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    m_dist.reset(new hacc::Distribution(comm, n, nb, nullptr));
+    m_dfft.reset(new hacc::Dfft(*m_dist));
+
+    const std::size_t local_size = m_dfft->local_size();
+    m_a.resize(local_size);
+    m_b.resize(local_size);
+    m_dfft->makePlans(m_a.data(), m_b.data(), m_a.data(), m_b.data());
+
+    // Eigenvalues of the 7-point Laplacian in the k-space pencil
+    const Real* dx = m_geom.CellSize();
+    const Real dhinv[3] = {Real(1.0)/(dx[2]*dx[2]),
+                           Real(1.0)/(dx[1]*dx[1]),
+                           Real(1.0)/(dx[0]*dx[0])};
+    const Real scale = Real(1.0)/static_cast<Real>(m_dfft->global_size());
+    const Real tpi = Real(2.0)*Real(3.141592653589793238462643383279502884197);
+    const int* self = m_dfft->self_kspace();
+    const int* local_ng = m_dfft->local_ng_kspace();
+    const int* global_ng = m_dfft->global_ng();
+
+    m_inv_eigen.resize(local_size);
+    std::size_t idx = 0;
+    for (int i = 0; i < local_ng[0]; ++i) {
+        const int gi = local_ng[0]*self[0] + i;
+        const Real ei = Real(2.0)*dhinv[0]*(std::cos(tpi*gi/global_ng[0]) - Real(1.0));
+        for (int j = 0; j < local_ng[1]; ++j) {
+            const int gj = local_ng[1]*self[1] + j;
+            const Real ej = Real(2.0)*dhinv[1]*(std::cos(tpi*gj/global_ng[1]) - Real(1.0));
+            for (int k = 0; k < local_ng[2]; ++k) {
+                const int gk = local_ng[2]*self[2] + k;
+                const Real ek = Real(2.0)*dhinv[2]*(std::cos(tpi*gk/global_ng[2]) - Real(1.0));
+                if (gi == 0 && gj == 0 && gk == 0) {
+                    m_inv_eigen[idx] = Real(0.0);
+                } else {
+                    m_inv_eigen[idx] = scale / (ei+ej+ek);
+                }
+                ++idx;
+            }
+        }
+    }
+}
+
+SWFFTPoisson::~SWFFTPoisson ()
+{
+}
+
+void
+SWFFTPoisson::solve (MultiFab& sol, const MultiFab& rhs)
+{
+    BL_PROFILE("SWFFTPoisson::solve()");
+
+    AMREX_ASSERT(sol.nComp() == 1 && rhs.nComp() == 1);
+
+    m_phi.ParallelCopy(rhs, 0, 0, 1);
+    Gpu::streamSynchronize();
+
+    for (MFIter mfi(m_phi); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& phi = m_phi.array(mfi);
+        const auto lo = amrex::lbound(mfi.validbox());
+        const auto hi = amrex::ubound(mfi.validbox());
+
+        std::size_t idx = 0;
+        for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    m_a[idx++] = std::complex<double>(phi(i,j,k), 0.0);
+                }
+            }
+        }
+
+        m_dfft->forward(m_a.data());
+
+        const std::size_t nk = m_inv_eigen.size();
+        for (std::size_t n = 0; n < nk; ++n) {
+            m_a[n] *= m_inv_eigen[n];
+        }
+
+        m_dfft->backward(m_a.data());
+
+        idx = 0;
+        for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    phi(i,j,k) = static_cast<Real>(std::real(m_a[idx++]));
+                }
+            }
+        }
+    }
+
+    sol.ParallelCopy(m_phi, 0, 0, 1);
+}
+
+}
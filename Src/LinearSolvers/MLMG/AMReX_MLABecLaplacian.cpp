@@ -3,6 +3,7 @@
 #include <AMReX_MultiFabUtil.H>
 
 #include <AMReX_MLABecLap_K.H>
+#include <AMReX_MLLinOp_K.H>
 
 namespace amrex {
 
@@ -376,6 +377,9 @@ MLABecLaplacian::prepareForSolve ()
         }
     }
 
+    m_deep_a_coeffs.clear();
+    m_deep_b_coeffs.clear();
+
     m_needs_update = false;
 }
 
@@ -462,6 +466,33 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
     }
 }
 
+void
+MLABecLaplacian::getDiagInv (int amrlev, int mglev, MultiFab& dinv) const
+{
+    dinv.setVal(1.0);
+    normalize(amrlev, mglev, dinv);
+
+    // overset cells are left alone
+    if (m_overset_mask[amrlev][mglev])
+    {
+        const int ncomp = getNComp();
+        const iMultiFab& osm = *m_overset_mask[amrlev][mglev];
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(dinv, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& fab = dinv.array(mfi);
+            const auto& osmfab = osm.const_array(mfi);
+            amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (osmfab(i,j,k) == 0) fab(i,j,k,n) = 0.0;
+            });
+        }
+    }
+}
+
 void
 MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
@@ -593,6 +624,180 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+bool
+MLABecLaplacian::canMultiSmooth (int amrlev, int mglev, int ngrow) const
+{
+    // Only then are all the boundaries of the grids either between grids
+    // or on the domain.
+    if (amrlev != 0 || !m_domain_covered[0] || m_overset_mask[amrlev][mglev]) return false;
+
+    if (m_use_chebyshev) return false;
+
+    // the line solve of semi-coarsening is not redundant
+    if (mglev > 0 && !(mg_coarsen_ratio_vec[mglev-1] == mg_coarsen_ratio)) return false;
+
+    // The ghost cells are computed from at most two interior cells, the
+    // first of which is updated in the same half sweep.
+    if (maxorder > 3) return false;
+
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        if (geom.isPeriodic(idim)) {
+            // the coloring of the periodic images has to agree, and the
+            // ghost cells may not wrap around more than once
+            if (domain.length(idim) % 2 != 0 || domain.length(idim) < ngrow) return false;
+        } else {
+            for (int n = 0; n < getNComp(); ++n) {
+                for (const auto bc : {m_lobc[n][idim], m_hibc[n][idim]}) {
+                    if (bc != BCType::Dirichlet && bc != BCType::Neumann &&
+                        bc != BCType::reflect_odd) return false;
+                }
+            }
+        }
+    }
+
+    // so that every grid uses maxorder points for the boundary conditions
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        if (ba[i].shortside()+1 < maxorder) return false;
+    }
+
+    return true;
+}
+
+void
+MLABecLaplacian::multiSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              int nsweeps, bool skip_fillboundary) const
+{
+    const int ngrow = 2*nsweeps;
+    if (nsweeps <= 1 || !canMultiSmooth(amrlev, mglev, ngrow)) {
+        MLCellABecLap::multiSmooth(amrlev, mglev, sol, rhs, nsweeps, skip_fillboundary);
+        return;
+    }
+
+    BL_PROFILE("MLABecLaplacian::multiSmooth()");
+
+    const int nc = getNComp();
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const auto& period = geom.periodicity();
+
+    if (m_deep_a_coeffs.size() <= mglev) {
+        m_deep_a_coeffs.resize(mglev+1);
+        m_deep_b_coeffs.resize(mglev+1);
+    }
+    MultiFab& acoef = m_deep_a_coeffs[mglev];
+    if (!acoef.ok() || acoef.nGrow() < ngrow)
+    {
+        const MultiFab& a = m_a_coeffs[amrlev][mglev];
+        acoef.define(a.boxArray(), a.DistributionMap(), a.nComp(), ngrow);
+        MultiFab::Copy(acoef, a, 0, 0, a.nComp(), 0);
+        acoef.FillBoundary(period);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const MultiFab& b = m_b_coeffs[amrlev][mglev][idim];
+            MultiFab& bcoef = m_deep_b_coeffs[mglev][idim];
+            bcoef.define(b.boxArray(), b.DistributionMap(), b.nComp(), ngrow);
+            MultiFab::Copy(bcoef, b, 0, 0, b.nComp(), 0);
+            bcoef.FillBoundary(period);
+        }
+    }
+    AMREX_D_TERM(const MultiFab& bxcoef = m_deep_b_coeffs[mglev][0];,
+                 const MultiFab& bycoef = m_deep_b_coeffs[mglev][1];,
+                 const MultiFab& bzcoef = m_deep_b_coeffs[mglev][2];);
+
+    // The half sweeps do not update the cells outside the domain, and in
+    // the periodic directions never reach the faces of dbox.
+    Box dbox = geom.Domain();
+    const Real* dxinv = geom.InvCellSize();
+    Vector<MLABecDomainBC> domain_bc(nc);
+    for (int n = 0; n < nc; ++n)
+    {
+        for (OrientationIter oitr; oitr; ++oitr)
+        {
+            const Orientation face = oitr();
+            const int idim = face.coordDir();
+            Real& c1 = domain_bc[n].c1[face];
+            Real& c2 = domain_bc[n].c2[face];
+            Real& f  = domain_bc[n].f [face];
+            c1 = c2 = f = 0.0;
+            if (geom.isPeriodic(idim)) {
+                if (n == 0) dbox.grow(face, ngrow);
+                continue;
+            }
+            const BCType bct = face.isLow() ? m_lobc[n][idim] : m_hibc[n][idim];
+            if (bct == BCType::Dirichlet) {
+                const Real bcl = face.isLow() ? m_domain_bloc_lo[idim] : m_domain_bloc_hi[idim];
+                GpuArray<Real,4> x{{-bcl * dxinv[idim], Real(0.5), Real(1.5), Real(2.5)}};
+                GpuArray<Real,4> coef{};
+                poly_interp_coeff(-Real(0.5), &x[0], maxorder, &coef[0]);
+                c1 = coef[1];
+                c2 = coef[2];
+                f  = coef[1];
+            } else if (bct == BCType::Neumann) {
+                c1 = 1.0;
+                f  = 1.0;
+            } else {
+                c1 = -1.0;
+                f  = 1.0;
+            }
+        }
+    }
+
+    const Real* h = geom.CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+    const Real alpha = m_a_scalar;
+
+    // sol and rhs together, so that one FillBoundary is enough
+    MultiFab deep(sol.boxArray(), sol.DistributionMap(), 2*nc, ngrow);
+    MultiFab::Copy(deep, sol, 0, 0, nc, 0);
+    MultiFab::Copy(deep, rhs, 0, nc, nc, 0);
+    deep.FillBoundary(period);
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+
+    for (int s = 0; s < 2*nsweeps; ++s)
+    {
+        const int redblack = s % 2;
+#ifdef AMREX_SOFT_PERF_COUNTERS
+        perf_counters.smooth(sol);
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(deep,mfi_info); mfi.isValid(); ++mfi)
+        {
+            // the cells whose values the remaining half sweeps need
+            const Box& bx = mfi.growntilebox(ngrow-1-s) & dbox;
+            const auto& phi = deep.array(mfi);
+            const Array4<Real const> rhsfab(deep.const_array(mfi), nc);
+            const auto& afab = acoef.const_array(mfi);
+            AMREX_D_TERM(const auto& bxfab = bxcoef.const_array(mfi);,
+                         const auto& byfab = bycoef.const_array(mfi);,
+                         const auto& bzfab = bzcoef.const_array(mfi););
+
+            for (int n = 0; n < nc; ++n)
+            {
+                const MLABecDomainBC bc = domain_bc[n];
+                AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA ( bx, thread_box,
+                {
+                    abec_gsrb_deep(thread_box, phi, rhsfab, alpha, afab,
+                                   AMREX_D_DECL(dhx, dhy, dhz),
+                                   AMREX_D_DECL(bxfab, byfab, bzfab),
+                                   dbox, bc, redblack, n);
+                });
+            }
+        }
+    }
+
+    MultiFab::Copy(sol, deep, 0, 0, nc, 0);
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -716,6 +921,10 @@ MLABecLaplacian::update ()
         }
     }
 
+    m_deep_a_coeffs.clear();
+    m_deep_b_coeffs.clear();
+    clearChebyshev();
+
     m_needs_update = false;
 }
 
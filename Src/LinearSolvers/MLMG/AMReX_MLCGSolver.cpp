@@ -49,6 +49,107 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+//
+// Sums and maxima reduced over the bottom communicator with non-blocking
+// MPI calls, so that the communication can overlap with the application
+// of the operator between start() and wait().
+//
+class AsyncAllReduce
+{
+public:
+
+    AsyncAllReduce (int nsum, int nmax, MPI_Comm comm)
+        : m_sum(nsum, 0.0), m_max(nmax, std::numeric_limits<Real>::lowest()), m_comm(comm)
+    {}
+
+    ~AsyncAllReduce () { wait(); }
+
+    AsyncAllReduce (const AsyncAllReduce&) = delete;
+    AsyncAllReduce& operator= (const AsyncAllReduce&) = delete;
+
+    Real& sum (int i) noexcept { return m_sum[i]; }
+    Real& max (int i) noexcept { return m_max[i]; }
+
+    void start ()
+    {
+#ifdef BL_USE_MPI
+        const auto mpi_type = ParallelDescriptor::Mpi_typemap<Real>::type();
+        if (!m_sum.empty()) {
+            MPI_Iallreduce(MPI_IN_PLACE, m_sum.data(), m_sum.size(), mpi_type,
+                           MPI_SUM, m_comm, &m_req[0]);
+        }
+        if (!m_max.empty()) {
+            MPI_Iallreduce(MPI_IN_PLACE, m_max.data(), m_max.size(), mpi_type,
+                           MPI_MAX, m_comm, &m_req[1]);
+        }
+#endif
+    }
+
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        MPI_Waitall(2, m_req, MPI_STATUSES_IGNORE);
+#endif
+    }
+
+private:
+    Vector<Real> m_sum;
+    Vector<Real> m_max;
+    MPI_Comm m_comm;
+#ifdef BL_USE_MPI
+    MPI_Request m_req[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+#endif
+};
+
+//
+// Solves the small dense system a x = b of size n in place by Gaussian
+// elimination with partial pivoting after a symmetric diagonal scaling.
+// a is row major.  Returns false if a is singular.
+//
+bool
+small_solve (int n, Real* a, Real* b)
+{
+    Vector<Real> d(n);
+    for (int i = 0; i < n; ++i) {
+        const Real aii = std::abs(a[i*n+i]);
+        d[i] = (aii > Real(0.0)) ? Real(1.0)/std::sqrt(aii) : Real(1.0);
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            a[i*n+j] *= d[i]*d[j];
+        }
+        b[i] *= d[i];
+    }
+
+    for (int k = 0; k < n; ++k) {
+        int piv = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(a[i*n+k]) > std::abs(a[piv*n+k])) piv = i;
+        }
+        if (std::abs(a[piv*n+k]) <= std::numeric_limits<Real>::epsilon()*Real(n)) {
+            return false;
+        }
+        if (piv != k) {
+            for (int j = 0; j < n; ++j) std::swap(a[k*n+j], a[piv*n+j]);
+            std::swap(b[k], b[piv]);
+        }
+        for (int i = k+1; i < n; ++i) {
+            const Real f = a[i*n+k]/a[k*n+k];
+            for (int j = k; j < n; ++j) a[i*n+j] -= f*a[k*n+j];
+            b[i] -= f*b[k];
+        }
+    }
+    for (int i = n-1; i >= 0; --i) {
+        Real r = b[i];
+        for (int j = i+1; j < n; ++j) r -= a[i*n+j]*b[j];
+        b[i] = r/a[i*n+i];
+    }
+
+    for (int i = 0; i < n; ++i) b[i] *= d[i];
+    return true;
+}
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -71,9 +172,16 @@ MLCGSolver::solve (MultiFab&       sol,
                    Real            eps_rel,
                    Real            eps_abs)
 {
-    if (solver_type == Type::BiCGStab) {
+    switch (solver_type) {
+    case Type::BiCGStab:
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
-    } else {
+    case Type::PipelinedBiCGStab:
+        return solve_pipelined_bicgstab(sol,rhs,eps_rel,eps_abs);
+    case Type::PipelinedCG:
+        return solve_pipelined_cg(sol,rhs,eps_rel,eps_abs);
+    case Type::SStepCG:
+        return solve_sstep_cg(sol,rhs,eps_rel,eps_abs);
+    default:
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
 }
@@ -396,6 +504,628 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipelined_bicgstab (MultiFab&       sol,
+                                      const MultiFab& rhs,
+                                      Real            eps_rel,
+                                      Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_bicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // w and z are the inputs of the operator and need its ghost cells
+    MultiFab w(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab z(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    auto apply = [&] (MultiFab& out, MultiFab& in)
+    {
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, out);
+    };
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    // w = A r and t = A w, with (rh,r) and (rh,w) reduced during the latter
+    MultiFab::Copy(z,r,0,0,ncomp,nghost);
+    apply(w, z);
+    Real rho, alpha, omega = 0, beta = 0;
+    {
+        AsyncAllReduce red(2, 0, Lp.BottomCommunicator());
+        red.sum(0) = dotxy(rh,r,true);
+        red.sum(1) = dotxy(rh,w,true);
+        red.start();
+        apply(t, w);
+        red.wait();
+        rho = red.sum(0);
+        if ( rho == 0 || red.sum(1) == 0 ) {
+            ret = 1;
+        } else {
+            alpha = rho/red.sum(1);
+        }
+    }
+
+    for (; ret == 0 && iter <= maxiter; ++iter)
+    {
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        AsyncAllReduce red1(2, 1, Lp.BottomCommunicator());
+        red1.sum(0) = dotxy(q,y,true);
+        red1.sum(1) = dotxy(y,y,true);
+        red1.max(0) = norm_inf(q,true);
+        red1.start();
+        apply(v, z);
+        red1.wait();
+
+        rnorm = red1.max(0);
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Half Iter "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+        {
+            sxay(sol, sol, alpha, p, nghost);
+            break;
+        }
+
+        if ( red1.sum(1) != Real(0.0) )
+        {
+            omega = red1.sum(0)/red1.sum(1);
+        }
+        else
+        {
+            ret = 3; break;
+        }
+
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r, q, -omega, y, nghost);
+        sxay(t, t, -alpha, v, nghost);
+        sxay(w, y, -omega, t, nghost);
+
+        AsyncAllReduce red2(4, 1, Lp.BottomCommunicator());
+        red2.sum(0) = dotxy(rh,r,true);
+        red2.sum(1) = dotxy(rh,w,true);
+        red2.sum(2) = dotxy(rh,s,true);
+        red2.sum(3) = dotxy(rh,z,true);
+        red2.max(0) = norm_inf(r,true);
+        red2.start();
+        apply(t, w);
+        red2.wait();
+
+        rnorm = red2.max(0);
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Iteration "
+                           << std::setw(11) << iter
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+
+        const Real rho_new = red2.sum(0);
+        if ( rho_new == 0 )
+        {
+            ret = 1; break;
+        }
+        beta = (alpha/omega)*(rho_new/rho);
+        const Real denom = red2.sum(1) + beta*red2.sum(2) - beta*omega*red2.sum(3);
+        if ( denom != Real(0.0) )
+        {
+            alpha = rho_new/denom;
+        }
+        else
+        {
+            ret = 2; break;
+        }
+        rho = rho_new;
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_pipelined_cg (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_cg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // w is the input of the operator and needs its ghost cells
+    MultiFab w(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipelinedCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    // w = A r
+    MultiFab::Copy(w,r,0,0,ncomp,nghost);
+    Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    MultiFab::Copy(w,q,0,0,ncomp,nghost);
+
+    Real gamma_1 = 0, alpha = 0;
+    bool converged = false;
+
+    for (; iter <= maxiter; ++iter)
+    {
+        // (r,r), (w,r) and the norm of r are reduced while q = A w
+        AsyncAllReduce red(2, 1, Lp.BottomCommunicator());
+        red.sum(0) = dotxy(r,r,true);
+        red.sum(1) = dotxy(w,r,true);
+        red.max(0) = norm_inf(r,true);
+        red.start();
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        red.wait();
+
+        if ( iter > 1 )
+        {
+            rnorm = red.max(0);
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG: Iteration"
+                               << std::setw(4) << iter-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true;
+                --iter;
+                break;
+            }
+        }
+
+        const Real gamma = red.sum(0);
+        const Real delta = red.sum(1);
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real beta = 0;
+        Real denom = delta;
+        if ( iter > 1 )
+        {
+            beta = gamma/gamma_1;
+            denom -= beta*gamma/alpha;
+        }
+        if ( denom != Real(0.0) )
+        {
+            alpha = gamma/denom;
+        }
+        else
+        {
+            ret = 1; break;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedCG:"
+                           << " iter " << iter
+                           << " gamma " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        if ( iter == 1 )
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(  r,   r,-alpha, s, nghost);
+        sxay(  w,   w,-alpha, z, nghost);
+
+        gamma_1 = gamma;
+    }
+
+    if ( ret == 0 && !converged )
+    {
+        // The norm of the last update has not been reduced yet.
+        iter = std::min(iter, maxiter);
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_sstep_cg (MultiFab&       sol,
+                            const MultiFab& rhs,
+                            Real            eps_rel,
+                            Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::sstep_cg");
+
+    const int ncomp = sol.nComp();
+    const int ns = sstep;
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // Monomial basis V_j = (A/sigma)^j r, j = 0,...,ns.  The first ns are
+    // inputs of the operator and need its ghost cells.
+    Vector<MultiFab> V(ns+1);
+    for (auto& mf : V) {
+        mf.define(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+        mf.setVal(0.0);
+    }
+    // Search directions P and A P of the last and of the current block
+    Vector<MultiFab> P(ns), AP(ns), Pn(ns), APn(ns);
+    for (int j = 0; j < ns; ++j) {
+        P  [j].define(ba, dm, ncomp, nghost, MFInfo(), factory);
+        AP [j].define(ba, dm, ncomp, nghost, MFInfo(), factory);
+        Pn [j].define(ba, dm, ncomp, nghost, MFInfo(), factory);
+        APn[j].define(ba, dm, ncomp, nghost, MFInfo(), factory);
+    }
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int ret = 0;
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_SStepCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Real sigma = 1.0;
+    // P^T A P of the last block, row major
+    Vector<Real> G_1(ns*ns, 0.0);
+    bool converged = false;
+
+    for (int k = 0; iter < maxiter; ++k)
+    {
+        MultiFab::Copy(V[0],r,0,0,ncomp,nghost);
+        for (int j = 0; j < ns; ++j) {
+            Lp.apply(amrlev, mglev, V[j+1], V[j], MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            if (sigma != Real(1.0)) V[j+1].mult(Real(1.0)/sigma, 0, ncomp, nghost);
+        }
+
+        // The only global reduction of the block:
+        //   g_i = (V_i,r), M_ij = (V_i,V_j+1), C_ij = (AP_i,V_j), e_i = (P_i,r),
+        //   the norm of V_1 for the scaling, and the max norm of r.
+        const int nsum = ns + ns*ns + ns*ns + ns + 1;
+        AsyncAllReduce red(nsum, 1, Lp.BottomCommunicator());
+        const int ig = 0, iM = ns, iC = ns + ns*ns, ie = ns + 2*ns*ns, iv = nsum-1;
+        for (int i = 0; i < ns; ++i) {
+            red.sum(ig+i) = dotxy(V[i], r, true);
+            for (int j = 0; j < ns; ++j) {
+                red.sum(iM+i*ns+j) = dotxy(V[i], V[j+1], true);
+            }
+        }
+        if (k > 0) {
+            for (int i = 0; i < ns; ++i) {
+                for (int j = 0; j < ns; ++j) {
+                    red.sum(iC+i*ns+j) = dotxy(AP[i], V[j], true);
+                }
+                red.sum(ie+i) = dotxy(P[i], r, true);
+            }
+        }
+        red.sum(iv) = dotxy(V[1], V[1], true);
+        red.max(0) = norm_inf(r, true);
+        red.start();
+        red.wait();
+
+        if (k > 0)
+        {
+            rnorm = red.max(0);
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_SStepCG: Iteration"
+                               << std::setw(4) << iter
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        // A V_j = sigma V_j+1
+        Vector<Real> G(ns*ns), c(ns), B(ns*ns, 0.0);
+        for (int i = 0; i < ns; ++i) {
+            c[i] = red.sum(ig+i);
+            for (int j = 0; j < ns; ++j) {
+                G[i*ns+j] = sigma*Real(0.5)*(red.sum(iM+i*ns+j) + red.sum(iM+j*ns+i));
+            }
+        }
+
+        if (k > 0)
+        {
+            // B = -G_1^{-1} C makes the new block A-conjugate to the last
+            for (int j = 0; j < ns; ++j) {
+                Vector<Real> a(G_1), col(ns);
+                for (int i = 0; i < ns; ++i) col[i] = -red.sum(iC+i*ns+j);
+                if (!small_solve(ns, a.data(), col.data())) {
+                    ret = 1; break;
+                }
+                for (int i = 0; i < ns; ++i) B[i*ns+j] = col[i];
+            }
+            if (ret != 0) break;
+
+            // G += C^T B and c += B^T e
+            for (int i = 0; i < ns; ++i) {
+                for (int j = 0; j < ns; ++j) {
+                    Real ctb = 0.0;
+                    for (int l = 0; l < ns; ++l) {
+                        ctb += red.sum(iC+l*ns+i) * B[l*ns+j];
+                    }
+                    G[i*ns+j] += ctb;
+                }
+                for (int l = 0; l < ns; ++l) {
+                    c[i] += B[l*ns+i] * red.sum(ie+l);
+                }
+            }
+            for (int i = 0; i < ns; ++i) {
+                for (int j = 0; j < i; ++j) {
+                    G[i*ns+j] = G[j*ns+i] = Real(0.5)*(G[i*ns+j] + G[j*ns+i]);
+                }
+            }
+        }
+
+        Vector<Real> a(G);
+        if (!small_solve(ns, a.data(), c.data())) {
+            ret = 1; break;
+        }
+
+        // P_new = V + P B, A P_new = A V + A P B
+        for (int j = 0; j < ns; ++j)
+        {
+            MultiFab::Copy(Pn[j], V[j], 0, 0, ncomp, nghost);
+            MultiFab::Copy(APn[j], V[j+1], 0, 0, ncomp, nghost);
+            if (sigma != Real(1.0)) APn[j].mult(sigma, 0, ncomp, nghost);
+            if (k > 0) {
+                for (int i = 0; i < ns; ++i) {
+                    MultiFab::Saxpy(Pn [j], B[i*ns+j], P [i], 0, 0, ncomp, nghost);
+                    MultiFab::Saxpy(APn[j], B[i*ns+j], AP[i], 0, 0, ncomp, nghost);
+                }
+            }
+        }
+        std::swap(P, Pn);
+        std::swap(AP, APn);
+
+        for (int j = 0; j < ns; ++j) {
+            MultiFab::Saxpy(sol,  c[j],  P[j], 0, 0, ncomp, nghost);
+            MultiFab::Saxpy(r,   -c[j], AP[j], 0, 0, ncomp, nghost);
+        }
+
+        G_1 = G;
+        iter += ns;
+
+        // Keep the basis vectors of the next block at the scale of r
+        const Real v0v0 = red.sum(ig);
+        const Real v1v1 = red.sum(iv);
+        if (v0v0 > Real(0.0) && v1v1 > Real(0.0)) {
+            sigma *= std::sqrt(v1v1/v0v0);
+        }
+    }
+
+    if ( ret == 0 && !converged )
+    {
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_SStepCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
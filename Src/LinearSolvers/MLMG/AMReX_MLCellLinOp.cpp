@@ -351,6 +351,10 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (m_use_chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs);
+        return;
+    }
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -576,6 +580,96 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     }
 }
 
+void
+MLCellLinOp::applyBCSP (int amrlev, int mglev, SPMultiFab& in, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::applyBCSP()");
+
+    AMREX_ASSERT(isCrossStencil() && getNComp() == 1);
+
+    if (!skip_fillboundary) {
+        in.FillBoundary(m_geom[amrlev][mglev].periodicity(), true);
+    }
+
+    const int imaxorder = maxorder;
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+    const auto& maskvals = m_maskvals[amrlev][mglev];
+    const auto& bcondloc = *m_bcondloc[amrlev][mglev];
+
+    FArrayBox foofab(Box::TheUnitBox(),1);
+    const auto& foo = foofab.const_array();
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(in, mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx   = mfi.validbox();
+        const auto& iofab = in.array(mfi);
+
+        const auto & bdlv = bcondloc.bndryLocs(mfi);
+        const auto & bdcv = bcondloc.bndryConds(mfi);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const Box blo = amrex::adjCellLo(vbx, idim);
+            const Box bhi = amrex::adjCellHi(vbx, idim);
+            const int blen = vbx.length(idim);
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            const BoundCond bctlo = bdcv[0][olo];
+            const BoundCond bcthi = bdcv[0][ohi];
+            const Real bcllo = bdlv[0][olo];
+            const Real bclhi = bdlv[0][ohi];
+            const Real dxi = dxinv[idim];
+            if (idim == 0) {
+                AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                blo, tboxlo, {
+                mllinop_apply_bc_x(0, tboxlo, blen, iofab, mlo,
+                                   bctlo, bcllo, foo,
+                                   imaxorder, dxi, 0, 0);
+                },
+                bhi, tboxhi, {
+                mllinop_apply_bc_x(1, tboxhi, blen, iofab, mhi,
+                                   bcthi, bclhi, foo,
+                                   imaxorder, dxi, 0, 0);
+                });
+            } else if (idim == 1) {
+                AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                blo, tboxlo, {
+                mllinop_apply_bc_y(0, tboxlo, blen, iofab, mlo,
+                                   bctlo, bcllo, foo,
+                                   imaxorder, dxi, 0, 0);
+                },
+                bhi, tboxhi, {
+                mllinop_apply_bc_y(1, tboxhi, blen, iofab, mhi,
+                                   bcthi, bclhi, foo,
+                                   imaxorder, dxi, 0, 0);
+                });
+            } else {
+                AMREX_LAUNCH_HOST_DEVICE_FUSIBLE_LAMBDA (
+                blo, tboxlo, {
+                mllinop_apply_bc_z(0, tboxlo, blen, iofab, mlo,
+                                   bctlo, bcllo, foo,
+                                   imaxorder, dxi, 0, 0);
+                },
+                bhi, tboxhi, {
+                mllinop_apply_bc_z(1, tboxhi, blen, iofab, mhi,
+                                   bcthi, bclhi, foo,
+                                   imaxorder, dxi, 0, 0);
+                });
+            }
+        }
+    }
+}
+
 void
 MLCellLinOp::reflux (int crse_amrlev,
                      MultiFab& res, const MultiFab& crse_sol, const MultiFab&,
@@ -750,6 +844,8 @@ MLCellLinOp::prepareForSolve ()
 {
     BL_PROFILE("MLCellLinOp::prepareForSolve()");
 
+    clearChebyshev();
+
     const int imaxorder = maxorder;
     const int ncomp = getNComp();
     for (int amrlev = 0;  amrlev < m_num_amr_levels; ++amrlev)
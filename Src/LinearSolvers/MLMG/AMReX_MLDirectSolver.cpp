@@ -0,0 +1,484 @@
+
+#include <AMReX_MLDirectSolver.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Loop.H>
+#include <AMReX_Print.H>
+
+#ifdef AMREX_USE_EB
+#include <AMReX_EBFabFactory.H>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace amrex {
+
+namespace {
+
+//
+// Number of colors in a direction.  Three separate the neighbors of a
+// stencil of radius one.  In periodic directions the colors must also
+// repeat with the period.
+//
+int
+num_colors (int len, bool periodic)
+{
+    if (!periodic) return 3;
+    if (len < 3) return len;
+    for (int m = 3; m < len; ++m) {
+        if (len % m == 0) return m;
+    }
+    return len;
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+int
+color_of (int i, int lo, int m) noexcept
+{
+    return ((i-lo) % m + m) % m;
+}
+
+//
+// Number of the i-th of len points in a direction.  Periodic directions
+// are numbered 0, len-1, 1, len-2, ... so that the neighbors across the
+// period stay close.
+//
+int
+point_number (int i, int len, bool periodic) noexcept
+{
+    if (!periodic) return i;
+    return (2*i < len) ? 2*i : 2*(len-1-i)+1;
+}
+
+//
+// Largest difference between the numbers of two neighboring points
+//
+int
+max_neighbor_distance (int len, bool periodic)
+{
+    int d = 0;
+    const int nneighbors = periodic ? len : len-1;
+    for (int i = 0; i < nneighbors; ++i) {
+        d = std::max(d, std::abs(point_number(i, len, periodic) -
+                                 point_number((i+1)%len, len, periodic)));
+    }
+    return d;
+}
+
+int
+my_rank (MPI_Comm comm)
+{
+    int r = 0;
+#ifdef BL_USE_MPI
+    MPI_Comm_rank(comm, &r);
+#else
+    amrex::ignore_unused(comm);
+#endif
+    return r;
+}
+
+template <class T>
+void
+gatherv (const Vector<T>& send, Vector<T>& recv, Vector<int>& counts, Vector<int>& displs,
+         int root, MPI_Comm comm)
+{
+#ifdef BL_USE_MPI
+    int myproc, nprocs;
+    MPI_Comm_rank(comm, &myproc);
+    MPI_Comm_size(comm, &nprocs);
+    int n = send.size();
+    counts.resize(nprocs);
+    MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+    if (myproc == root) {
+        displs.resize(nprocs);
+        displs[0] = 0;
+        std::partial_sum(counts.begin(), counts.end()-1, displs.begin()+1);
+        recv.resize(displs.back() + counts.back());
+    }
+    const auto mpi_type = ParallelDescriptor::Mpi_typemap<T>::type();
+    MPI_Gatherv(const_cast<T*>(send.data()), n, mpi_type,
+                recv.data(), counts.data(), displs.data(), mpi_type, root, comm);
+#else
+    amrex::ignore_unused(root, comm);
+    recv = send;
+    counts.assign(1, send.size());
+    displs.assign(1, 0);
+#endif
+}
+
+}
+
+MLDirectSolver::MLDirectSolver (MLLinOp& a_lp)
+    : Lp(a_lp),
+      amrlev(0),
+      mglev(a_lp.NMGLevels(0)-1),
+      m_comm(a_lp.BottomCommunicator())
+{
+}
+
+MLDirectSolver::~MLDirectSolver ()
+{
+}
+
+bool
+MLDirectSolver::isSupported (const MLLinOp& a_lp)
+{
+    if (a_lp.getNComp() != 1 || !a_lp.m_domain_covered[0]) return false;
+
+    if (a_lp.isCellCentered())
+    {
+        // maxorder 4 extrapolates from three cells at the domain boundary
+        if (a_lp.getMaxOrder() > 3) return false;
+#ifdef AMREX_USE_EB
+        // the Dirichlet fluxes on the EB reach two cells away
+        auto factory = dynamic_cast<EBFArrayBoxFactory const*>
+            (a_lp.Factory(0, a_lp.NMGLevels(0)-1));
+        if (factory && !factory->isAllRegular()) return false;
+#endif
+    }
+    return true;
+}
+
+bool
+MLDirectSolver::define ()
+{
+    BL_PROFILE("MLDirectSolver::define()");
+
+    const bool nodal = !Lp.isCellCentered();
+    const Geometry& geom = Lp.Geom(amrlev, mglev);
+    const Box& domain = geom.Domain();
+    const IntVect dlo = domain.smallEnd();
+
+    // Number of distinct points and of colors in each direction.  The rows
+    // are numbered with the longest direction varying slowest, which keeps
+    // the band narrow.
+    IntVect len, ncolor, stride;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const bool periodic = geom.isPeriodic(idim);
+        len[idim] = domain.length(idim) + ((nodal && !periodic) ? 1 : 0);
+        ncolor[idim] = num_colors(len[idim], periodic);
+    }
+    Array<int,AMREX_SPACEDIM> perm;
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(perm.begin(), perm.end(), [&] (int a, int b) { return len[a] < len[b]; });
+    Long n = 1;
+    for (int idim : perm) {
+        stride[idim] = n;
+        n *= len[idim];
+    }
+
+    // The bandwidth of a stencil of radius one, which the assembled matrix
+    // cannot exceed.  Checking it first avoids assembling a matrix whose
+    // factors would not fit.
+    Long kmax = 0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        kmax += max_neighbor_distance(len[idim], geom.isPeriodic(idim)) * stride[idim];
+    }
+    if ((3*kmax+1)*n > max_band_size) {
+        if (verbose > 0) {
+            amrex::Print() << "MLDirectSolver: " << n << " rows with bandwidths up to "
+                           << kmax << " are too many\n";
+        }
+        return false;
+    }
+    m_n = n;
+
+    auto row_of = [&] (IntVect const& p) -> int
+    {
+        int r = 0;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int ii = color_of(p[idim], dlo[idim], len[idim]);
+            r += point_number(ii, len[idim], geom.isPeriodic(idim)) * stride[idim];
+        }
+        return r;
+    };
+
+    const IntVect ixtype = nodal ? IntVect::TheNodeVector() : IntVect::TheCellVector();
+    const BoxArray ba = amrex::convert(Lp.m_grids[amrlev][mglev], ixtype);
+    const DistributionMapping& dm = Lp.m_dmap[amrlev][mglev];
+    MultiFab x(ba, dm, 1, 1, MFInfo(), *Lp.Factory(amrlev,mglev));
+    MultiFab y(ba, dm, 1, 0, MFInfo(), *Lp.Factory(amrlev,mglev));
+#ifdef AMREX_USE_GPU
+    MultiFab yhost(ba, dm, 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+#endif
+
+    m_local_row.clear();
+    for (MFIter mfi(y); mfi.isValid(); ++mfi) {
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            m_local_row.push_back(row_of(IntVect(AMREX_D_DECL(i,j,k))));
+        });
+    }
+
+    // Column c of row p is found in A x where x is one on all the points of
+    // the color of c, because no other point of that color is a neighbor of p.
+    Vector<int> rows, cols;
+    Vector<Real> vals;
+    const int ncolors = AMREX_D_TERM(ncolor[0], *ncolor[1], *ncolor[2]);
+    for (int icolor = 0; icolor < ncolors; ++icolor)
+    {
+        IntVect c;
+        for (int idim = 0, rem = icolor; idim < AMREX_SPACEDIM; ++idim) {
+            c[idim] = rem % ncolor[idim];
+            rem /= ncolor[idim];
+        }
+
+        x.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(x,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& xa = x.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                const IntVect p(AMREX_D_DECL(i,j,k));
+                bool on = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    on = on && color_of(p[idim], dlo[idim], ncolor[idim]) == c[idim];
+                }
+                xa(i,j,k) = on ? 1.0 : 0.0;
+            });
+        }
+
+        Lp.apply(amrlev, mglev, y, x, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        const MultiFab* yp = &y;
+#ifdef AMREX_USE_GPU
+        MultiFab::Copy(yhost, y, 0, 0, 1, 0);
+        Gpu::streamSynchronize();
+        yp = &yhost;
+#endif
+
+        for (MFIter mfi(*yp); mfi.isValid(); ++mfi)
+        {
+            const auto& ya = yp->const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                const Real v = ya(i,j,k);
+                if (v == 0.0) return;
+                const IntVect p(AMREX_D_DECL(i,j,k));
+                IntVect q = p;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    int delta = -1;
+                    while (delta <= 1 && color_of(p[idim]+delta, dlo[idim], ncolor[idim]) != c[idim]) {
+                        ++delta;
+                    }
+                    q[idim] += delta;
+                    if (delta > 1 || (!geom.isPeriodic(idim) &&
+                                      (q[idim] < dlo[idim] || q[idim] >= dlo[idim]+len[idim]))) {
+                        return;
+                    }
+                }
+                rows.push_back(row_of(p));
+                cols.push_back(row_of(q));
+                vals.push_back(v);
+            });
+        }
+    }
+
+    const bool is_root = my_rank(m_comm) == m_root;
+
+    gatherv(m_local_row, m_all_row, m_counts, m_displs, m_root, m_comm);
+    Vector<int> all_rows, all_cols, counts, displs;
+    Vector<Real> all_vals;
+    gatherv(rows, all_rows, counts, displs, m_root, m_comm);
+    gatherv(cols, all_cols, counts, displs, m_root, m_comm);
+    gatherv(vals, all_vals, counts, displs, m_root, m_comm);
+
+    int ok = 1;
+    if (is_root)
+    {
+        m_kl = 0;
+        m_ku = 0;
+        for (int i = 0, N = all_rows.size(); i < N; ++i) {
+            m_kl = std::max(m_kl, all_rows[i]-all_cols[i]);
+            m_ku = std::max(m_ku, all_cols[i]-all_rows[i]);
+        }
+
+        // Partial pivoting needs room for kl more superdiagonals
+        const Long width = 2*m_kl + m_ku + 1;
+        if (width*m_n > max_band_size)
+        {
+            ok = 0;
+        }
+        else
+        {
+            // A singular problem is made regular by fixing the last point.
+            // Rows without entries, such as those of Dirichlet nodes, get a
+            // one on the diagonal.
+            m_pinned = Lp.isBottomSingular();
+            m_band.assign(width*m_n, 0.0);
+            Vector<char> has_entry(m_n, 0);
+            for (int i = 0, N = all_rows.size(); i < N; ++i) {
+                const int r = all_rows[i];
+                if (m_pinned && r == m_n-1) continue;
+                m_band[r*width + (all_cols[i]-r+m_kl)] = all_vals[i];
+                has_entry[r] = 1;
+            }
+            for (int r = 0; r < m_n; ++r) {
+                if (!has_entry[r]) m_band[r*width + m_kl] = 1.0;
+            }
+            ok = factorize();
+        }
+
+        if (verbose > 0) {
+            amrex::Print() << "MLDirectSolver: " << m_n << " rows, bandwidths "
+                           << m_kl << " " << m_ku
+                           << (ok ? "" : ", band too large or matrix singular") << "\n";
+        }
+        if (!ok) {
+            m_band.clear();
+            m_ipiv.clear();
+        }
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Bcast(&ok, 1, MPI_INT, m_root, m_comm);
+#endif
+
+    m_defined = ok;
+    return m_defined;
+}
+
+bool
+MLDirectSolver::factorize ()
+{
+    BL_PROFILE("MLDirectSolver::factorize()");
+
+    const int n = m_n;
+    const int kl = m_kl;
+    const int ku = m_kl + m_ku;
+    const Long width = kl + ku + 1;
+    auto a = [&] (int i, int j) -> Real& { return m_band[i*width + (j-i+kl)]; };
+
+    m_ipiv.resize(n);
+    for (int k = 0; k < n; ++k)
+    {
+        const int imax = std::min(n-1, k+kl);
+        const int jmax = std::min(n-1, k+ku);
+
+        int p = k;
+        for (int i = k+1; i <= imax; ++i) {
+            if (std::abs(a(i,k)) > std::abs(a(p,k))) p = i;
+        }
+        m_ipiv[k] = p;
+        if (a(p,k) == 0.0) return false;
+
+        if (p != k) {
+            for (int j = k; j <= jmax; ++j) std::swap(a(k,j), a(p,j));
+        }
+
+        const Real dinv = 1.0/a(k,k);
+        for (int i = k+1; i <= imax; ++i) {
+            const Real l = a(i,k)*dinv;
+            a(i,k) = l;
+            if (l != 0.0) {
+                for (int j = k+1; j <= jmax; ++j) a(i,j) -= l*a(k,j);
+            }
+        }
+    }
+    return true;
+}
+
+void
+MLDirectSolver::backsolve (Vector<Real>& b) const
+{
+    const int n = m_n;
+    const int kl = m_kl;
+    const int ku = m_kl + m_ku;
+    const Long width = kl + ku + 1;
+    auto a = [&] (int i, int j) -> Real { return m_band[i*width + (j-i+kl)]; };
+
+    for (int k = 0; k < n; ++k) {
+        if (m_ipiv[k] != k) std::swap(b[k], b[m_ipiv[k]]);
+        const int imax = std::min(n-1, k+kl);
+        for (int i = k+1; i <= imax; ++i) b[i] -= a(i,k)*b[k];
+    }
+    for (int i = n-1; i >= 0; --i) {
+        Real s = b[i];
+        const int jmax = std::min(n-1, i+ku);
+        for (int j = i+1; j <= jmax; ++j) s -= a(i,j)*b[j];
+        b[i] = s/a(i,i);
+    }
+}
+
+void
+MLDirectSolver::solve (MultiFab& sol, const MultiFab& rhs)
+{
+    BL_PROFILE("MLDirectSolver::solve()");
+
+    AMREX_ASSERT(m_defined);
+
+    const MultiFab* rp = &rhs;
+#ifdef AMREX_USE_GPU
+    MultiFab host(rhs.boxArray(), rhs.DistributionMap(), 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+    MultiFab::Copy(host, rhs, 0, 0, 1, 0);
+    Gpu::streamSynchronize();
+    rp = &host;
+#endif
+
+    Vector<Real> local;
+    local.reserve(m_local_row.size());
+    for (MFIter mfi(*rp); mfi.isValid(); ++mfi) {
+        const auto& ra = rp->const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            local.push_back(ra(i,j,k));
+        });
+    }
+
+    const bool is_root = my_rank(m_comm) == m_root;
+
+    Vector<Real> all(is_root ? m_all_row.size() : 0);
+#ifdef BL_USE_MPI
+    const auto mpi_type = ParallelDescriptor::Mpi_typemap<Real>::type();
+    MPI_Gatherv(local.data(), local.size(), mpi_type,
+                all.data(), m_counts.data(), m_displs.data(), mpi_type, m_root, m_comm);
+#else
+    all = local;
+#endif
+
+    if (is_root)
+    {
+        Vector<Real> b(m_n, 0.0);
+        for (int i = 0, N = all.size(); i < N; ++i) {
+            b[m_all_row[i]] = all[i];
+        }
+        if (m_pinned) b[m_n-1] = 0.0;
+
+        backsolve(b);
+
+        for (int i = 0, N = all.size(); i < N; ++i) {
+            all[i] = b[m_all_row[i]];
+        }
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Scatterv(all.data(), m_counts.data(), m_displs.data(), mpi_type,
+                 local.data(), local.size(), mpi_type, m_root, m_comm);
+#else
+    local = all;
+#endif
+
+#ifdef AMREX_USE_GPU
+    MultiFab& sp = host;
+#else
+    MultiFab& sp = sol;
+#endif
+    int ip = 0;
+    for (MFIter mfi(sp); mfi.isValid(); ++mfi) {
+        const auto& sa = sp.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            sa(i,j,k) = local[ip++];
+        });
+    }
+#ifdef AMREX_USE_GPU
+    MultiFab::Copy(sol, host, 0, 0, 1, 0);
+#endif
+}
+
+}
@@ -0,0 +1,315 @@
+
+#include <AMReX_MLFGMRES.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFabUtil.H>
+
+#include <cmath>
+#include <iomanip>
+
+namespace amrex {
+
+MLFGMRES::MLFGMRES (MLMG& a_mlmg)
+    : mlmg(a_mlmg),
+      linop(a_mlmg.linop),
+      namrlevs(a_mlmg.linop.NAMRLevels()),
+      ncomp(a_mlmg.linop.getNComp())
+{
+}
+
+MLFGMRES::~MLFGMRES ()
+{
+}
+
+void
+MLFGMRES::define (const Vector<MultiFab const*>& a_rhs)
+{
+    if (!m_mask.empty()) return;
+
+    m_mask.resize(namrlevs);
+    const auto& amrrr = linop.AMRRefRatio();
+    for (int alev = 0; alev < namrlevs-1; ++alev)
+    {
+        m_mask[alev] = makeFineMask(*a_rhs[alev], *a_rhs[alev+1], IntVect(0),
+                                    IntVect(amrrr[alev]), Periodicity::NonPeriodic(), 1, 0);
+        if (!linop.isCellCentered()) {
+            linop.fixUpResidualMask(alev, m_mask[alev]);
+        }
+    }
+}
+
+void
+MLFGMRES::makeVector (Vector<MultiFab>& v, int nghost) const
+{
+    v.resize(namrlevs);
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        v[alev].define(linop.m_grids[alev][0], linop.m_dmap[alev][0], ncomp, nghost,
+                       MFInfo(), *linop.Factory(alev));
+    }
+}
+
+Real
+MLFGMRES::dotxy (const Vector<MultiFab>& x, const Vector<MultiFab>& y) const
+{
+    Real r = 0.0;
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        if (alev < namrlevs-1) {
+            r += MultiFab::Dot(m_mask[alev], x[alev], 0, y[alev], 0, ncomp, 0, true);
+        } else {
+            r += MultiFab::Dot(x[alev], 0, y[alev], 0, ncomp, 0, true);
+        }
+    }
+    return r;
+}
+
+Real
+MLFGMRES::norm2 (const Vector<MultiFab>& x) const
+{
+    Real r = dotxy(x, x);
+    ParallelAllReduce::Sum(r, ParallelContext::CommunicatorSub());
+    return std::sqrt(r);
+}
+
+void
+MLFGMRES::saxpy (Vector<MultiFab>& y, Real a, const Vector<MultiFab>& x) const
+{
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::Saxpy(y[alev], a, x[alev], 0, 0, ncomp, 0);
+    }
+}
+
+void
+MLFGMRES::applyHomogeneous (Vector<MultiFab>& out, Vector<MultiFab>& in,
+                            const Vector<MultiFab>& g)
+{
+    mlmg.apply(GetVecOfPtrs(out), GetVecOfPtrs(in));
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::Subtract(out[alev], g[alev], 0, 0, ncomp, 0);
+    }
+}
+
+void
+MLFGMRES::computeResidual (Vector<MultiFab>& res, const Vector<MultiFab*>& a_sol,
+                           const Vector<MultiFab const*>& a_rhs)
+{
+    mlmg.apply(GetVecOfPtrs(res), a_sol);
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::Xpay(res[alev], Real(-1.0), *a_rhs[alev], 0, 0, ncomp, 0);
+    }
+
+    // GMRES cannot reduce the part of the residual in the null space
+    if (namrlevs == 1 && linop.isSingular(0) && linop.getEnforceSingularSolvable())
+    {
+        mlmg.computeVolInv();
+        mlmg.makeSolvable(0, 0, res[0]);
+    }
+}
+
+void
+MLFGMRES::orthogonalize (Vector<MultiFab>& w, const Vector<Vector<MultiFab> >& v, int n,
+                         Real* h) const
+{
+    for (int i = 0; i < n; ++i) {
+        h[i] = 0.0;
+    }
+
+    if (orthogonalization == Orthogonalization::MGS)
+    {
+        for (int i = 0; i < n; ++i) {
+            Real hi = dotxy(w, v[i]);
+            ParallelAllReduce::Sum(hi, ParallelContext::CommunicatorSub());
+            saxpy(w, -hi, v[i]);
+            h[i] = hi;
+        }
+    }
+    else
+    {
+        const int npass = (orthogonalization == Orthogonalization::CGS2) ? 2 : 1;
+        Vector<Real> hp(n);
+        for (int pass = 0; pass < npass; ++pass) {
+            for (int i = 0; i < n; ++i) {
+                hp[i] = dotxy(w, v[i]);
+            }
+            ParallelAllReduce::Sum(hp.data(), n, ParallelContext::CommunicatorSub());
+            for (int i = 0; i < n; ++i) {
+                saxpy(w, -hp[i], v[i]);
+                h[i] += hp[i];
+            }
+        }
+    }
+}
+
+Real
+MLFGMRES::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
+                 Real a_tol_rel, Real a_tol_abs)
+{
+    BL_PROFILE("MLFGMRES::solve()");
+
+    AMREX_ASSERT(namrlevs <= a_sol.size());
+    AMREX_ASSERT(namrlevs <= a_rhs.size());
+
+    Real solve_start_time = amrex::second();
+
+    define(a_rhs);
+
+    m_res_history.clear();
+
+    const int m = restart_length;
+    const int ng = linop.isCellCentered() ? 1 : 0;
+
+    // The Krylov basis, the preconditioned directions and the
+    // homogeneous part of the operator, g = L(0)
+    Vector<Vector<MultiFab> > v(m+1);
+    Vector<Vector<MultiFab> > z(m);
+    for (auto& vi : v) makeVector(vi, 0);
+    for (auto& zi : z) makeVector(zi, ng);
+    Vector<MultiFab> g, tmp;
+    makeVector(g, 0);
+    makeVector(tmp, ng);
+
+    for (auto& mf : tmp) mf.setVal(0.0);
+    mlmg.apply(GetVecOfPtrs(g), GetVecOfPtrs(tmp));
+
+    Real rhsnorm0;
+    {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Copy(v[0][alev], *a_rhs[alev], 0, 0, ncomp, 0);
+        }
+        rhsnorm0 = norm2(v[0]);
+    }
+
+    computeResidual(v[0], a_sol, a_rhs);
+    const Real resnorm0 = norm2(v[0]);
+
+    if (verbose >= 1)
+    {
+        amrex::Print() << "MLFGMRES: Initial rhs               = " << rhsnorm0 << "\n"
+                       << "MLFGMRES: Initial residual (resid0) = " << resnorm0 << "\n";
+    }
+
+    const Real max_norm = std::max(rhsnorm0, resnorm0);
+    const std::string norm_name = (rhsnorm0 >= resnorm0) ? "bnorm" : "resid0";
+    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,Real(1.e-16))*max_norm);
+
+    // Hessenberg matrix in column major order, Givens rotations and the
+    // right hand side of the least squares problem
+    Vector<Real> H((m+1)*m);
+    Vector<Real> cs(m), sn(m), s(m+1), y(m);
+
+    Real resnorm = resnorm0;
+    bool converged = (resnorm <= res_target);
+    int iter = 0;
+
+    if (converged && verbose >= 1) {
+        amrex::Print() << "MLFGMRES: No iterations needed\n";
+    }
+
+    while (!converged && iter < max_iters)
+    {
+        const Real beta = resnorm;
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            v[0][alev].mult(Real(1.0)/beta, 0, ncomp, 0);
+        }
+        std::fill(s.begin(), s.end(), Real(0.0));
+        s[0] = beta;
+
+        int k = 0;
+        while (k < m && iter < max_iters)
+        {
+            // z_k = M^{-1} v_k.  The MLMG iteration is affine in the right
+            // hand side, so M^{-1} v = MLMG(v + L(0)) with zero initial guess.
+            for (int alev = 0; alev < namrlevs; ++alev) {
+                MultiFab::LinComb(tmp[alev], Real(1.0), v[k][alev], 0,
+                                  Real(1.0), g[alev], 0, 0, ncomp, 0);
+            }
+            mlmg.precond(GetVecOfPtrs(z[k]), GetVecOfConstPtrs(tmp));
+
+            applyHomogeneous(v[k+1], z[k], g);
+
+            Real* hk = &H[k*(m+1)];
+            orthogonalize(v[k+1], v, k+1, hk);
+            hk[k+1] = norm2(v[k+1]);
+            if (hk[k+1] > Real(0.0)) {
+                for (int alev = 0; alev < namrlevs; ++alev) {
+                    v[k+1][alev].mult(Real(1.0)/hk[k+1], 0, ncomp, 0);
+                }
+            }
+
+            for (int i = 0; i < k; ++i) {
+                const Real t = cs[i]*hk[i] + sn[i]*hk[i+1];
+                hk[i+1] = -sn[i]*hk[i] + cs[i]*hk[i+1];
+                hk[i] = t;
+            }
+            const Real d = std::sqrt(hk[k]*hk[k] + hk[k+1]*hk[k+1]);
+            if (d > Real(0.0)) {
+                cs[k] = hk[k] / d;
+                sn[k] = hk[k+1] / d;
+            } else {
+                cs[k] = Real(1.0);
+                sn[k] = Real(0.0);
+            }
+            hk[k] = d;
+            hk[k+1] = Real(0.0);
+            s[k+1] = -sn[k]*s[k];
+            s[k] = cs[k]*s[k];
+
+            ++k;
+            ++iter;
+
+            resnorm = std::abs(s[k]);
+            m_res_history.push_back(resnorm);
+            if (verbose >= 2) {
+                amrex::Print() << "MLFGMRES: Iteration " << std::setw(3) << iter << " resid/"
+                               << norm_name << " = " << resnorm/max_norm << "\n";
+            }
+
+            // happy breakdown if the basis cannot be extended
+            if (resnorm <= res_target || d == Real(0.0)) break;
+        }
+
+        // sol += Z y with H y = s
+        for (int i = k-1; i >= 0; --i) {
+            Real t = s[i];
+            for (int j = i+1; j < k; ++j) {
+                t -= H[j*(m+1)+i] * y[j];
+            }
+            y[i] = t / H[i*(m+1)+i];
+        }
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            for (int j = 0; j < k; ++j) {
+                MultiFab::Saxpy(*a_sol[alev], y[j], z[j][alev], 0, 0, ncomp, 0);
+            }
+        }
+
+        // restart from the true residual
+        computeResidual(v[0], a_sol, a_rhs);
+        resnorm = norm2(v[0]);
+        converged = (resnorm <= res_target);
+    }
+
+    if (converged) {
+        if (verbose >= 1) {
+            amrex::Print() << "MLFGMRES: Final Iter. " << iter
+                           << " resid, resid/" << norm_name << " = "
+                           << resnorm << ", " << resnorm/max_norm << "\n";
+        }
+    } else {
+        if (verbose > 0) {
+            amrex::Print() << "MLFGMRES: Failed to converge after " << iter << " iterations."
+                           << " resid, resid/" << norm_name << " = "
+                           << resnorm << ", " << resnorm/max_norm << "\n";
+        }
+        amrex::Abort("MLFGMRES failed");
+    }
+
+    if (verbose >= 1) {
+        Real solve_time = amrex::second() - solve_start_time;
+        ParallelReduce::Max<Real>(solve_time, 0, ParallelContext::CommunicatorSub());
+        amrex::Print() << "MLFGMRES: Solve time = " << solve_time << "\n";
+    }
+
+    return resnorm;
+}
+
+}
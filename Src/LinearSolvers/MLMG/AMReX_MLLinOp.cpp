@@ -648,6 +648,135 @@ MLLinOp::make (Vector<Vector<MultiFab> >& mf, int nc, int ng) const
     }
 }
 
+void
+MLLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs) const
+{
+    BL_PROFILE("MLLinOp::chebyshevSmooth()");
+
+    const int ncomp = getNComp();
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = *m_factory[amrlev][mglev];
+
+    if (m_cheby_dinv.empty()) {
+        m_cheby_dinv.resize(m_num_amr_levels);
+        m_cheby_lambda.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_cheby_dinv[alev].resize(m_num_mg_levels[alev]);
+            m_cheby_lambda[alev].resize(m_num_mg_levels[alev], 0.0);
+        }
+    }
+
+    MultiFab Ax(ba, dm, ncomp, 0, MFInfo(), factory);
+
+    if (!m_cheby_dinv[amrlev][mglev])
+    {
+        m_cheby_dinv[amrlev][mglev].reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), factory));
+        MultiFab& dinv = *m_cheby_dinv[amrlev][mglev];
+        getDiagInv(amrlev, mglev, dinv);
+
+        // Power iteration for the largest eigenvalue of dinv*A, starting
+        // from a pseudo-random vector so that all the modes are present.
+        MultiFab x(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(x,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& xfab = x.array(mfi);
+            amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                unsigned int h = static_cast<unsigned int>(i)*73856093u
+                    ^ static_cast<unsigned int>(j)*19349663u
+                    ^ static_cast<unsigned int>(k)*83492791u
+                    ^ static_cast<unsigned int>(n)*2654435761u;
+                h ^= h >> 13;
+                h *= 0x5bd1e995u;
+                h ^= h >> 15;
+                xfab(i,j,k,n) = static_cast<Real>(h & 1023u)/Real(1023.) - Real(0.5);
+            });
+        }
+
+        // The ratio of the max norms errs on the large side, which is the
+        // safe side for the Chebyshev polynomial.
+        auto maxnorm = [ncomp] (MultiFab const& mf) -> Real {
+            Real r = 0.0;
+            for (int n = 0; n < ncomp; ++n) r = std::max(r, mf.norm0(n));
+            return r;
+        };
+
+        constexpr int niters = 10;
+        Real lambda = 0.0;
+        Real xnorm = maxnorm(x);
+        for (int it = 0; it < niters && xnorm > 0.0; ++it)
+        {
+            apply(amrlev, mglev, Ax, x, BCMode::Homogeneous, StateMode::Correction);
+            MultiFab::Multiply(Ax, dinv, 0, 0, ncomp, 0);
+            const Real ynorm = maxnorm(Ax);
+            lambda = ynorm / xnorm;
+            if (ynorm == 0.0) break;
+            MultiFab::Copy(x, Ax, 0, 0, ncomp, 0);
+            x.mult(1.0/ynorm, 0, ncomp, 0);
+            xnorm = 1.0;
+        }
+        m_cheby_lambda[amrlev][mglev] = lambda;
+
+        if (verbose >= 4) {
+            amrex::Print() << "MLLinOp::chebyshevSmooth: AMR level " << amrlev << " MG level "
+                           << mglev << " eigenvalue estimate " << lambda << "\n";
+        }
+    }
+
+    const MultiFab& dinv = *m_cheby_dinv[amrlev][mglev];
+    const Real lambda = m_cheby_lambda[amrlev][mglev];
+    if (lambda <= 0.0) return;
+
+    // Target the upper part of the spectrum, [0.1, 1.1] times the estimate.
+    const Real emax = Real(1.1)*lambda;
+    const Real emin = Real(0.1)*lambda;
+    const Real theta = Real(0.5)*(emax+emin);
+    const Real delta = Real(0.5)*(emax-emin);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    MultiFab d(ba, dm, ncomp, 0, MFInfo(), factory);
+
+    for (int ideg = 0; ideg < m_chebyshev_degree; ++ideg)
+    {
+        apply(amrlev, mglev, Ax, sol, BCMode::Homogeneous, StateMode::Correction);
+
+        Real c1 = 0.0, c2 = 1.0/theta;
+        if (ideg > 0) {
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            c1 = rho_new*rho;
+            c2 = 2.0*rho_new/delta;
+            rho = rho_new;
+        }
+        const bool first = ideg == 0;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(sol,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& solfab = sol.array(mfi);
+            const auto& dfab = d.array(mfi);
+            const auto& rhsfab = rhs.const_array(mfi);
+            const auto& axfab = Ax.const_array(mfi);
+            const auto& dinvfab = dinv.const_array(mfi);
+            amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                Real dn = c2*dinvfab(i,j,k,n)*(rhsfab(i,j,k,n)-axfab(i,j,k,n));
+                if (!first) dn += c1*dfab(i,j,k,n);
+                dfab(i,j,k,n) = dn;
+                solfab(i,j,k,n) += dn;
+            });
+        }
+    }
+}
+
 void
 MLLinOp::setDomainBC (const Array<BCType,AMREX_SPACEDIM>& a_lobc,
                       const Array<BCType,AMREX_SPACEDIM>& a_hibc) noexcept
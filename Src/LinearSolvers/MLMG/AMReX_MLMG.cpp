@@ -4,6 +4,7 @@
 #include <AMReX_BC_TYPES.H>
 #include <AMReX_MLMG_K.H>
 #include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLPoisson.H>
 
 #ifdef AMREX_USE_PETSC
 #include <petscksp.h>
@@ -58,19 +59,8 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         checkPoint(a_sol, a_rhs, a_tol_rel, a_tol_abs, checkpoint_file);
     }
 
-    if (bottom_solver == BottomSolver::Default) {
-        bottom_solver = linop.getDefaultBottomSolver();
-    }
+    prepareBottomSolver(*a_sol[0]);
 
-    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc) {
-        int mo = linop.getMaxOrder();
-        if (a_sol[0]->hasEBFabFactory()) {
-            linop.setMaxOrder(2);
-        } else {
-            linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
-        }
-    }
-    
     bool is_nsolve = linop.m_parent;
 
     Real solve_start_time = amrex::second();
@@ -220,6 +210,69 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     return composite_norminf;
 }
 
+void
+MLMG::prepareBottomSolver (const MultiFab& a_sol)
+{
+    if (bottom_solver == BottomSolver::Default) {
+        bottom_solver = linop.getDefaultBottomSolver();
+    }
+
+    if (bottom_solver == BottomSolver::direct && !MLDirectSolver::isSupported(linop)) {
+        if (verbose > 0) {
+            amrex::Print() << "MLMG: this operator has no direct bottom solver, using bicgstab\n";
+        }
+        bottom_solver = BottomSolver::bicgstab;
+    }
+
+    if (bottom_solver == BottomSolver::fft && !isFFTBottomSupported()) {
+        if (verbose > 0) {
+            amrex::Print() << "MLMG: this operator has no FFT bottom solver, using bicgstab\n";
+        }
+        bottom_solver = BottomSolver::bicgstab;
+    }
+
+    if (bottom_solver == BottomSolver::hypre || bottom_solver == BottomSolver::petsc) {
+        int mo = linop.getMaxOrder();
+        if (a_sol.hasEBFabFactory()) {
+            linop.setMaxOrder(2);
+        } else {
+            linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
+        }
+    }
+}
+
+void
+MLMG::precond (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
+{
+    BL_PROFILE("MLMG::precond()");
+
+    prepareBottomSolver(*a_sol[0]);
+
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        a_sol[alev]->setVal(0.0);
+    }
+
+    // The setup of the operator and the allocations are reused after the
+    // first call
+    prepareForSolve(a_sol, a_rhs);
+
+    computeMLResidual(finest_amr_lev);
+
+    // an F-cycle if max_fmg_iters > 0
+    oneIter(0);
+
+    const int ncomp = linop.getNComp();
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        if (a_sol[alev] != sol[alev])
+        {
+            MultiFab::Copy(*a_sol[alev], *sol[alev], 0, 0, ncomp, 0);
+        }
+    }
+
+    ++solve_called;
+}
+
 // in  : Residual (res) on the finest AMR level
 // out : sol on all AMR levels
 void MLMG::oneIter (int iter)
@@ -254,6 +307,8 @@ void MLMG::oneIter (int iter)
 
         if (iter < max_fmg_iters) {
             mgFcycle ();
+        } else if (useSinglePrecisionVcycle()) {
+            mgVcycleSP ();
         } else {
             mgVcycle (0, 0);
         }
@@ -434,9 +489,9 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
         cor[amrlev][mglev]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
+        for (int i = 0; i < nu1; i += smooth_sweeps_per_fill) {
+            linop.multiSmooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                              std::min(smooth_sweeps_per_fill, nu1-i), skip_fillboundary);
             skip_fillboundary = false;
         }
 
@@ -484,9 +539,9 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         }
         cor[amrlev][mglev_bottom]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
-                         skip_fillboundary);
+        for (int i = 0; i < nu1; i += smooth_sweeps_per_fill) {
+            linop.multiSmooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
+                              std::min(smooth_sweeps_per_fill, nu1-i), skip_fillboundary);
             skip_fillboundary = false;
         }
         if (verbose >= 4)
@@ -512,8 +567,9 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
+        for (int i = 0; i < nu2; i += smooth_sweeps_per_fill) {
+            linop.multiSmooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                              std::min(smooth_sweeps_per_fill, nu2-i));
         }
 
 	if (cf_strategy == CFStrategy::ghostnodes) computeResOfCorrection(amrlev, mglev);
@@ -528,6 +584,222 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     }
 }
 
+bool
+MLMG::useSinglePrecisionVcycle () const
+{
+    if (!do_mixed_precision || linop.NMGLevels(0) < 2) return false;
+    if (!linop.supportsSinglePrecision()) return false;
+    if (!linop.m_domain_covered[0] || linop.doSemicoarsening()) return false;
+    return cf_strategy != CFStrategy::ghostnodes;
+}
+
+// V-cycle on AMR level 0 with single precision data on all but the
+// bottom MG level.  The bottom solve is done in Real.
+// in : res[0][0]
+// out: cor[0][0]
+void
+MLMG::mgVcycleSP ()
+{
+    BL_PROFILE("MLMG::mgVcycleSP()");
+
+    const int amrlev = 0;
+    const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+
+    if (sp_res.empty())
+    {
+        sp_res.resize(mglev_bottom);
+        sp_cor.resize(mglev_bottom);
+        sp_rescor.resize(mglev_bottom);
+        for (int mglev = 0; mglev < mglev_bottom; ++mglev)
+        {
+            const BoxArray& ba = res[amrlev][mglev].boxArray();
+            const DistributionMapping& dm = res[amrlev][mglev].DistributionMap();
+            sp_res   [mglev].reset(new SPMultiFab(ba, dm, 1, 0));
+            sp_cor   [mglev].reset(new SPMultiFab(ba, dm, 1, 1));
+            sp_rescor[mglev].reset(new SPMultiFab(ba, dm, 1, 0));
+        }
+    }
+
+    // Scale the residual to order one, so that it fits the range of float
+    // however small it has become.
+    const Real resnorm = res[amrlev][0].norm0();
+    if (resnorm == 0.0) {
+        cor[amrlev][0]->setVal(0.0);
+        return;
+    }
+    const Real scale = 1.0/resnorm;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*sp_res[0],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& dst = sp_res[0]->array(mfi);
+        const auto& src = res[amrlev][0].const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            dst(i,j,k) = static_cast<float>(src(i,j,k)*scale);
+        });
+    }
+
+    for (int mglev = 0; mglev < mglev_bottom; ++mglev)
+    {
+        sp_cor[mglev]->setVal(0.f);
+        smoothSP(mglev, nu1, true);
+        computeResOfCorrectionSP(mglev);
+
+        const SPMultiFab& fine = *sp_rescor[mglev];
+        BoxArray cba = fine.boxArray();
+        cba.coarsen(2);
+        const bool to_sp = mglev+1 < mglev_bottom;
+
+        SPMultiFab ctmp;
+        SPMultiFab* crse;
+        if (to_sp && amrex::isMFIterSafe(fine, *sp_res[mglev+1])) {
+            crse = sp_res[mglev+1].get();
+        } else {
+            ctmp.define(cba, fine.DistributionMap(), 1, 0);
+            crse = &ctmp;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(*crse,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& c = crse->array(mfi);
+            const auto& f = fine.const_array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                mlmg_sp_restriction(i,j,k,c,f);
+            });
+        }
+
+        if (to_sp) {
+            if (crse != sp_res[mglev+1].get()) sp_res[mglev+1]->ParallelCopy(ctmp);
+        } else {
+            MultiFab dtmp(cba, fine.DistributionMap(), 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(dtmp,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& dst = dtmp.array(mfi);
+                const auto& src = ctmp.const_array(mfi);
+                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    dst(i,j,k) = src(i,j,k);
+                });
+            }
+            res[amrlev][mglev_bottom].ParallelCopy(dtmp);
+        }
+    }
+
+    bottomSolve();
+
+    for (int mglev = mglev_bottom-1; mglev >= 0; --mglev)
+    {
+        addInterpCorrectionSP(mglev);
+        smoothSP(mglev, nu2, false);
+    }
+
+    MultiFab& cor0 = *cor[amrlev][0];
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cor0,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& dst = cor0.array(mfi);
+        const auto& src = sp_cor[0]->const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            dst(i,j,k) = src(i,j,k)*resnorm;
+        });
+    }
+    cor0.setBndry(0.0);
+}
+
+// Smoothing of sp_cor[mglev] with sp_res[mglev] as the rhs
+void
+MLMG::smoothSP (int mglev, int nsweeps, bool skip_fillboundary)
+{
+    BL_PROFILE("MLMG::smoothSP()");
+    for (int i = 0; i < nsweeps; ++i) {
+        linop.smoothSP(0, mglev, *sp_cor[mglev], *sp_res[mglev], skip_fillboundary);
+        skip_fillboundary = false;
+    }
+}
+
+// sp_rescor = sp_res - L(sp_cor)
+void
+MLMG::computeResOfCorrectionSP (int mglev)
+{
+    BL_PROFILE("MLMG::computeResOfCorrectionSP()");
+    linop.correctionResidualSP(0, mglev, *sp_rescor[mglev], *sp_cor[mglev], *sp_res[mglev]);
+}
+
+// sp_cor[mglev] += I(correction of mglev+1), which is cor[0][mglev+1] at
+// the bottom
+void
+MLMG::addInterpCorrectionSP (int mglev)
+{
+    BL_PROFILE("MLMG::addInterpCorrectionSP()");
+
+    const int mglev_bottom = linop.NMGLevels(0) - 1;
+    SPMultiFab& fine = *sp_cor[mglev];
+
+    SPMultiFab ctmp;
+    const SPMultiFab* cmf;
+    if (mglev+1 < mglev_bottom && amrex::isMFIterSafe(*sp_cor[mglev+1], fine))
+    {
+        cmf = sp_cor[mglev+1].get();
+    }
+    else
+    {
+        BoxArray cba = fine.boxArray();
+        cba.coarsen(2);
+        ctmp.define(cba, fine.DistributionMap(), 1, 0);
+        if (mglev+1 < mglev_bottom) {
+            ctmp.ParallelCopy(*sp_cor[mglev+1]);
+        } else {
+            MultiFab dtmp(cba, fine.DistributionMap(), 1, 0);
+            dtmp.ParallelCopy(*cor[0][mglev_bottom]);
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(ctmp,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& dst = ctmp.array(mfi);
+                const auto& src = dtmp.const_array(mfi);
+                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    dst(i,j,k) = static_cast<float>(src(i,j,k));
+                });
+            }
+        }
+        cmf = &ctmp;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& ffab = fine.array(mfi);
+        const auto& cfab = cmf->const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            ffab(i,j,k) += cfab(amrex::coarsen(i,2),amrex::coarsen(j,2),amrex::coarsen(k,2));
+        });
+    }
+}
+
 // FMG cycle on the coarsest AMR level.
 // in:  Residual on the top MG level (i.e., 0)
 // out: Correction (cor) on all MG levels
@@ -920,8 +1192,9 @@ MLMG::actualBottomSolve ()
     {
 
         bool skip_fillboundary = true;
-        for (int i = 0; i < nuf; ++i) {
-            linop.smooth(amrlev, mglev, x, b, skip_fillboundary);
+        for (int i = 0; i < nuf; i += smooth_sweeps_per_fill) {
+            linop.multiSmooth(amrlev, mglev, x, b, std::min(smooth_sweeps_per_fill, nuf-i),
+                              skip_fillboundary);
             skip_fillboundary = false;
         }
     }
@@ -939,6 +1212,26 @@ MLMG::actualBottomSolve ()
             makeSolvable(amrlev,mglev,*bottom_b);
         }
 
+        if (bottom_solver == BottomSolver::direct && direct_solver == nullptr)
+        {
+            makeDirectSolver();
+        }
+
+#ifdef AMREX_USE_SWFFT
+        if (bottom_solver == BottomSolver::fft && fft_solver == nullptr)
+        {
+            const Geometry& geom = linop.Geom(amrlev, mglev);
+            if (SWFFTPoisson::isSupported(geom, ParallelContext::NProcsSub())) {
+                fft_solver.reset(new SWFFTPoisson(geom));
+            } else {
+                if (verbose > 0) {
+                    amrex::Print() << "MLMG: bottom level cannot be decomposed for the FFT solver, switching to bicgstab\n";
+                }
+                bottom_solver = BottomSolver::bicgstab;
+            }
+        }
+#endif
+
         if (bottom_solver == BottomSolver::hypre)
         {
             bottomSolveWithHypre(x, *bottom_b);
@@ -947,12 +1240,26 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::direct)
+        {
+            bottomSolveWithDirect(x, *bottom_b);
+        }
+        else if (bottom_solver == BottomSolver::fft)
+        {
+            bottomSolveWithFFT(x, *bottom_b);
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipelinedCG;
+            } else if (bottom_solver == BottomSolver::pipebicgstab) {
+                cg_type = MLCGSolver::Type::PipelinedBiCGStab;
+            } else if (bottom_solver == BottomSolver::sstepcg) {
+                cg_type = MLCGSolver::Type::SStepCG;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -991,6 +1298,59 @@ MLMG::actualBottomSolve ()
     timer[bottom_time] += amrex::second() - bottom_start_time;
 }
 
+void
+MLMG::makeDirectSolver ()
+{
+    direct_solver.reset(new MLDirectSolver(linop));
+    direct_solver->setVerbose(bottom_verbose);
+    if (!direct_solver->define())
+    {
+        if (verbose > 0) {
+            amrex::Print() << "MLMG: bottom level too large for the direct solver, switching to bicgstab\n";
+        }
+        bottom_solver = BottomSolver::bicgstab;
+        direct_solver.reset();
+    }
+}
+
+void
+MLMG::bottomSolveWithDirect (MultiFab& x, const MultiFab& b)
+{
+    direct_solver->solve(x, b);
+
+    // For singular problems one point of the solution was fixed to zero
+    if (linop.isBottomSingular() && linop.getEnforceSingularSolvable())
+    {
+        makeSolvable(0, linop.NMGLevels(0)-1, x);
+    }
+}
+
+bool
+MLMG::isFFTBottomSupported () const
+{
+#if !defined(AMREX_USE_SWFFT)
+    return false;
+#else
+    if (dynamic_cast<MLPoisson const*>(&linop) == nullptr) return false;
+    if (linop.getNComp() != 1 || !linop.m_domain_covered[0]) return false;
+
+    const Geometry& geom = linop.Geom(0);
+    return AMREX_SPACEDIM == 3 && geom.isAllPeriodic() && geom.IsCartesian();
+#endif
+}
+
+void
+MLMG::bottomSolveWithFFT (MultiFab& x, const MultiFab& b)
+{
+#if !defined(AMREX_USE_SWFFT)
+    amrex::ignore_unused(x,b);
+    amrex::Abort("bottomSolveWithFFT is called without building with SWFFT");
+#else
+    // The solution has zero mean, as makeSolvable would give
+    fft_solver->solve(x, b);
+#endif
+}
+
 int
 MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
 {
@@ -998,6 +1358,7 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     cg_solver.setSolver(type);
     cg_solver.setVerbose(bottom_verbose);
     cg_solver.setMaxIter(bottom_maxiter);
+    cg_solver.setSStep(bottom_sstep);
     if (cf_strategy == CFStrategy::ghostnodes) cg_solver.setNGhost(linop.getNGrow());
 
     int ret = cg_solver.solve(x, b, bottom_reltol, bottom_abstol);
@@ -1143,6 +1504,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     } else if (linop.needsUpdate()) {
         linop.update();
 
+        direct_solver.reset();
+
 #ifdef AMREX_USE_HYPRE
         hypre_solver.reset();
         hypre_bndry.reset();
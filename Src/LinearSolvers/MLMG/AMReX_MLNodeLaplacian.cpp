@@ -1723,6 +1723,29 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
     }
 }
 
+void
+MLNodeLaplacian::getDiagInv (int amrlev, int mglev, MultiFab& dinv) const
+{
+    dinv.setVal(1.0);
+    normalize(amrlev, mglev, dinv);
+
+    // Dirichlet nodes are left alone
+    const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dinv,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& arr = dinv.array(mfi);
+        Array4<int const> const& dmskarr = dmsk.const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (dmskarr(i,j,k)) arr(i,j,k) = 0.0;
+        });
+    }
+}
+
 void
 MLNodeLaplacian::compSyncResidualCoarse (MultiFab& sync_resid, const MultiFab& a_phi,
                                          const MultiFab& vold, const MultiFab* rhcc,
@@ -131,6 +131,12 @@ void
 MLNodeLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
+    if (m_use_chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs);
+        // the boxes update their shared nodes independently
+        nodalSync(amrlev, mglev, sol);
+        return;
+    }
     if (!skip_fillboundary) {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
     }
@@ -55,6 +55,13 @@ void
 MLPoisson::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
 {
     BL_PROFILE("MLPoisson::Fapply()");
+    FapplyT(amrlev, mglev, out, in);
+}
+
+template <typename MF>
+void
+MLPoisson::FapplyT (int amrlev, int mglev, MF& out, const MF& in) const
+{
 
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
@@ -148,10 +155,36 @@ MLPoisson::normalize (int amrlev, int mglev, MultiFab& mf) const
 #endif
 }
 
+void
+MLPoisson::getDiagInv (int amrlev, int mglev, MultiFab& dinv) const
+{
+#if (AMREX_SPACEDIM != 3)
+    if (m_has_metric_term) {
+        dinv.setVal(1.0);
+        normalize(amrlev, mglev, dinv);
+        return;
+    }
+#endif
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    Real diag = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        diag -= 2.0*dxinv[idim]*dxinv[idim];
+    }
+    dinv.setVal(1.0/diag);
+}
+
 void
 MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
     BL_PROFILE("MLPoisson::Fsmooth()");
+    FsmoothT(amrlev, mglev, sol, rhs, redblack);
+}
+
+template <typename MF>
+void
+MLPoisson::FsmoothT (int amrlev, int mglev, MF& sol, const MF& rhs, int redblack) const
+{
 
     const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
     const auto& maskvals  = m_maskvals [amrlev][mglev];
@@ -287,6 +320,42 @@ MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, i
     }
 }
 
+void
+MLPoisson::smoothSP (int amrlev, int mglev, SPMultiFab& sol, const SPMultiFab& rhs,
+                     bool skip_fillboundary) const
+{
+    BL_PROFILE("MLPoisson::smoothSP()");
+    for (int redblack = 0; redblack < 2; ++redblack)
+    {
+        applyBCSP(amrlev, mglev, sol, skip_fillboundary);
+        FsmoothT(amrlev, mglev, sol, rhs, redblack);
+        skip_fillboundary = false;
+    }
+}
+
+void
+MLPoisson::correctionResidualSP (int amrlev, int mglev, SPMultiFab& resid,
+                                 SPMultiFab& x, const SPMultiFab& b) const
+{
+    BL_PROFILE("MLPoisson::correctionResidualSP()");
+    applyBCSP(amrlev, mglev, x);
+    FapplyT(amrlev, mglev, resid, x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(resid, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& rfab = resid.array(mfi);
+        const auto& bfab = b.const_array(mfi);
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            rfab(i,j,k) = bfab(i,j,k) - rfab(i,j,k);
+        });
+    }
+}
+
 void
 MLPoisson::FFlux (int amrlev, const MFIter& mfi,
                   const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -166,6 +166,22 @@ NodalProjector::setOptions ()
     {
         m_mlmg->setBottomSolver(MLMG::BottomSolver::cgbicg);
     }
+    else if (bottom_solver == "pipebicg")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::pipebicgstab);
+    }
+    else if (bottom_solver == "pipecg")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::pipecg);
+    }
+    else if (bottom_solver == "sstepcg")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::sstepcg);
+    }
+    else if (bottom_solver == "direct")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::direct);
+    }
 #ifdef AMREX_USE_HYPRE
     else if (bottom_solver == "hypre")
     {
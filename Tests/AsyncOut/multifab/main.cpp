@@ -1,6 +1,7 @@
 #include <AMReX.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_FPC.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_BLProfiler.H>
 
@@ -11,6 +12,20 @@ using namespace amrex;
 
 void main_main ();
 
+// Fills the valid and ghost cells with values that depend only on the cell
+// and the component, and that are exact in 32 bits
+void fillFloatExact (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const auto& a = mf.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = (i*131 + j*17 + k*7 + n*3) / 8.0;
+        });
+    }
+}
+
 int main (int argc, char* argv[])
 {
 
@@ -199,4 +214,58 @@ void main_main ()
         }
     }
     ParallelDescriptor::Barrier();
+
+// ***************************************************************
+
+    amrex::Print() << " Prefetched Read " << std::endl;
+    {
+        BL_PROFILE_REGION("vismf-prefetch-read");
+        VisMF::Header::Version saveVersion = VisMF::GetHeaderVersion();
+        VisMF::SetHeaderVersion(VisMF::Header::NoFabHeader_v1);
+        for (int m = 0; m < nwrites; ++m) {
+            VisMF::Write(mfs[m], std::string("vismfdata/prefetch-" + std::to_string(m)));
+        }
+        VisMF::SetHeaderVersion(saveVersion);
+
+        VisMF::SetUsePrefetchReads(true);
+        for (int m = 0; m < nwrites; ++m) {
+            MultiFab mfread(ba, dm, 1, 0);
+            VisMF::Read(mfread, std::string("vismfdata/prefetch-" + std::to_string(m)));
+            MultiFab::Subtract(mfread, mfs[m], 0, 0, 1, 0);
+            Real diff = mfread.norm0(0);
+            if (diff != 0.0)
+                { amrex::Print() << "Prefetched read failed: max diff = " << diff << std::endl; }
+        }
+
+        // ---- 32 bit data with ghost cells, read into a different
+        // ---- DistributionMapping, so the raw data is converted and then
+        // ---- redistributed
+        {
+            const int ncomp = 2;
+            const int ngrow = 2;
+            MultiFab mfw(ba, dm, ncomp, ngrow);
+            fillFloatExact(mfw);
+            VisMF::SetHeaderVersion(VisMF::Header::NoFabHeader_v1);
+            VisMF::Write(mfw, "vismfdata/prefetch-float", FPC::Ieee32NormalRealDescriptor());
+            VisMF::SetHeaderVersion(saveVersion);
+
+            Vector<int> pmap = dm.ProcessorMap();
+            for (auto& p : pmap) { p = ParallelDescriptor::NProcs() - 1 - p; }
+            DistributionMapping dmr(std::move(pmap));
+
+            MultiFab mfread(ba, dmr, ncomp, ngrow);
+            VisMF::Read(mfread, "vismfdata/prefetch-float");
+            MultiFab mfexact(ba, dmr, ncomp, ngrow);
+            fillFloatExact(mfexact);
+            MultiFab::Subtract(mfread, mfexact, 0, 0, ncomp, ngrow);
+            for (int n = 0; n < ncomp; ++n) {
+                Real diff = mfread.norm0(n, ngrow);
+                if (diff != 0.0) {
+                    amrex::Abort("Prefetched 32 bit read failed: max diff = " + std::to_string(diff));
+                }
+            }
+        }
+        VisMF::SetUsePrefetchReads(false);
+    }
+    ParallelDescriptor::Barrier();
 }
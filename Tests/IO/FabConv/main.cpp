@@ -0,0 +1,179 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_FabConv.H>
+#include <AMReX_FPC.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace amrex;
+
+void testFabConv ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running RealDescriptor conversion test \n";
+    testFabConv();
+
+    amrex::Finalize();
+}
+
+namespace {
+
+// Bitwise equality, except that any two NaNs compare equal
+template <typename T>
+bool same (T a, T b)
+{
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// An IEEE format with the bytes in the reverse of the native order
+RealDescriptor swapped (const RealDescriptor& native)
+{
+    Vector<int> ord = native.orderarray();
+    std::reverse(ord.begin(), ord.end());
+    return RealDescriptor(native.format(), ord.data(), ord.size());
+}
+
+// Values that exercise the rounding of double to float, the float and
+// double denormals, overflow, signed zeros, infinities and NaN.  The rest
+// of the array is filled with ordinary numbers so that the conversions go
+// through more than one read and write buffer.
+Vector<double> makeValues (int n)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    Vector<double> v = {
+        0.0, -0.0, 1.0, -1.0, 1.0/3.0, -2.0/3.0,
+        1.0 + 3.0*std::ldexp(1.0,-25), // rounds up to 1+2^-23, truncates to 1
+        1.0 + std::ldexp(1.0,-25),     // rounds down to 1
+        std::ldexp(1.0,-126),          // smallest normal float
+        std::ldexp(1.0,-149),          // smallest denormal float
+        std::ldexp(3.0,-140),          // denormal float
+        -1.e-40,                       // denormal float, rounded
+        std::ldexp(1.0,-151),          // underflows to 0 in float
+        std::numeric_limits<double>::denorm_min(),
+        std::ldexp(1.0,-1030),         // denormal double
+        static_cast<double>(std::numeric_limits<float>::max()),
+        1.e39, -1.e39,                 // overflow to +-inf in float
+        std::numeric_limits<double>::max(),
+        inf, -inf,
+        std::numeric_limits<double>::quiet_NaN()
+    };
+    for (int i = v.size(); i < n; ++i) {
+        v.push_back(std::sin(0.1*i) * std::pow(10.0, (i%61)-30));
+    }
+    return v;
+}
+
+}
+
+void testFabConv ()
+{
+    static_assert(sizeof(Real) == sizeof(double), "this test assumes double precision Real");
+
+    const int n = 100000;
+    const Vector<double> v = makeValues(n);
+
+    const RealDescriptor swapped64 = swapped(FPC::Native64RealDescriptor());
+    const RealDescriptor swapped32 = swapped(FPC::Native32RealDescriptor());
+
+    int nfail = 0;
+    auto check = [&nfail] (bool ok, const char* what, int i, double x) {
+        if (!ok) {
+            if (nfail < 20) {
+                amrex::Print() << "  " << what << " failed at " << i << " for "
+                               << std::setprecision(17) << x << "\n";
+            }
+            ++nfail;
+        }
+    };
+
+    // double to native float: IEEE round to nearest, denormals kept
+    {
+        Vector<float> f(n);
+        RealDescriptor::convertFromNativeFormat(f.data(), n, v.data(),
+                                                FPC::Native32RealDescriptor());
+        for (int i = 0; i < n; ++i) {
+            check(same(f[i], static_cast<float>(v[i])), "double to float", i, v[i]);
+        }
+        check(f[6] == 1.0f + std::ldexp(1.0f,-23), "round to nearest", 6, v[6]);
+        check(f[10] != 0.0f, "float denormal", 10, v[10]);
+
+        // and back to double, which is exact
+        Vector<double> d(n);
+        RealDescriptor::convertToNativeFormat(d.data(), n, f.data(),
+                                              FPC::Native32RealDescriptor());
+        for (int i = 0; i < n; ++i) {
+            check(same(d[i], static_cast<double>(f[i])), "float to double", i, v[i]);
+        }
+    }
+
+    // byte swapped double and float, through the in-memory conversions
+    for (const RealDescriptor* rd : {&swapped64, &swapped32})
+    {
+        const bool is64 = rd->numBytes() == 8;
+        Vector<char> buf(n*rd->numBytes());
+        RealDescriptor::convertFromNativeFormat(buf.data(), n, v.data(), *rd);
+        for (int i = 0; i < n; ++i) {
+            char* p = buf.data() + i*rd->numBytes();
+            std::reverse(p, p + rd->numBytes());
+            if (is64) {
+                double x;
+                std::memcpy(&x, p, sizeof(double));
+                check(same(x, v[i]), "double to swapped double", i, v[i]);
+            } else {
+                float x;
+                std::memcpy(&x, p, sizeof(float));
+                check(same(x, static_cast<float>(v[i])), "double to swapped float", i, v[i]);
+            }
+            std::reverse(p, p + rd->numBytes());
+        }
+
+        Vector<double> d(n);
+        RealDescriptor::convertToNativeFormat(d.data(), n, buf.data(), *rd);
+        for (int i = 0; i < n; ++i) {
+            const double expected = is64 ? v[i] : static_cast<double>(static_cast<float>(v[i]));
+            check(same(d[i], expected), "swapped round trip", i, v[i]);
+        }
+    }
+
+    // the same through streams, in all four IEEE formats
+    for (const RealDescriptor* rd : {&FPC::Native64RealDescriptor(), &FPC::Native32RealDescriptor(),
+                                     &swapped64, &swapped32})
+    {
+        const bool is64 = rd->numBytes() == 8;
+        std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+        RealDescriptor::convertFromNativeFormat(ss, n, v.data(), *rd);
+        AMREX_ALWAYS_ASSERT(ss.tellp() == std::streampos(Long(n)*rd->numBytes()));
+
+        Vector<double> d(n);
+        RealDescriptor::convertToNativeFormat(d.data(), n, ss, *rd);
+        for (int i = 0; i < n; ++i) {
+            const double expected = is64 ? v[i] : static_cast<double>(static_cast<float>(v[i]));
+            check(same(d[i], expected), "stream round trip", i, v[i]);
+        }
+
+        if (!is64) {
+            ss.clear();
+            ss.seekg(0);
+            Vector<float> f(n);
+            RealDescriptor::convertToNativeFloatFormat(f.data(), n, ss, *rd);
+            for (int i = 0; i < n; ++i) {
+                check(same(f[i], static_cast<float>(v[i])), "stream to float", i, v[i]);
+            }
+        }
+    }
+
+    if (nfail > 0) {
+        amrex::Abort("FabConv test failed with " + std::to_string(nfail) + " wrong values");
+    }
+    amrex::Print() << "  passed\n";
+}
@@ -0,0 +1,296 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_RealVect.H>
+
+#include <cmath>
+#include <limits>
+
+using namespace amrex;
+
+struct TestParams
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+};
+
+void testPrecision (const TestParams& params);
+void testProducts (const TestParams& params);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    TestParams params;
+    {
+        ParmParse pp;
+        pp.query("n_cell", params.n_cell);
+        pp.query("max_grid_size", params.max_grid_size);
+    }
+
+    amrex::Print() << "Running plotfile precision test \n";
+    testPrecision(params);
+
+    amrex::Print() << "Running plotfile products test \n";
+    testProducts(params);
+
+    amrex::Finalize();
+}
+
+namespace {
+
+Geometry makeGeometry (const TestParams& params)
+{
+    Box domain(IntVect(0), IntVect(params.n_cell-1));
+    RealBox real_box({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    return Geometry(domain, real_box, 0, is_periodic);
+}
+
+// The first cells hold values that are subnormal or out of range in half
+// and single precision, the others a smooth function over many decades.
+Real cellValue (int i, int j, int k, int n, int comp)
+{
+    constexpr int nspecial = 16;
+    const Real special[nspecial] = {
+        0.0, -0.0, 1.0, -1.0,
+        6.103515625e-05,        // smallest normal half
+        1.e-5, -3.e-7,          // subnormal half
+        1.e-9,                  // underflows in half
+        65504.0,                // largest half
+        1.e5, -7.e4,            // overflow in half
+        1.e-40,                 // subnormal float
+        1.e39, -1.e39,          // overflow in float
+        0.1, 1./3.
+    };
+    const int idx = i + n*(j + n*k);
+    if (comp == 0 && idx < nspecial) return special[idx];
+    return std::sin(0.3*i + 0.7*j + 1.1*k + comp) * std::pow(Real(10.0), Real(idx%9 - 4));
+}
+
+// The largest error of a rounded value of x in a format with the given
+// mantissa bits and smallest normal number, for finite results
+Real roundoff (Real x, int mantissa_bits, Real min_normal)
+{
+    const Real ulp = std::ldexp(Real(1.0), -mantissa_bits);
+    return std::max(std::abs(x), min_normal) * ulp;
+}
+
+}
+
+void testPrecision (const TestParams& params)
+{
+    const Geometry geom = makeGeometry(params);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncomp = 2;
+    MultiFab mf(ba, dm, ncomp, 0);
+    const int n = params.n_cell;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int c) {
+            a(i,j,k,c) = cellValue(i,j,k,n,c);
+        });
+    }
+
+    const Real half_max = 65504.0;
+    const Real float_max = std::numeric_limits<float>::max();
+
+    for (auto precision : {PlotFilePrecision::Float32, PlotFilePrecision::Float16})
+    {
+        const bool is_half = precision == PlotFilePrecision::Float16;
+        const std::string name = is_half ? "plt_float16" : "plt_float32";
+        WriteSingleLevelPlotfile(name, mf, {"a", "b"}, geom, 0.0, 0,
+                                 "HyperCLaw-V1.1", "Level_", "Cell", {}, precision);
+
+        PlotFileData pf(name);
+        AMREX_ALWAYS_ASSERT(pf.boxArray(0) == ba);
+        MultiFab mf2 = pf.get(0);
+        AMREX_ALWAYS_ASSERT(mf2.nComp() == ncomp);
+
+        Long nfail = 0;
+        for (MFIter mfi(mf2); mfi.isValid(); ++mfi) {
+            Array4<Real const> const& b = mf2.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int c) {
+                const Real x = cellValue(i,j,k,n,c);
+                const Real y = b(i,j,k,c);
+                bool ok;
+                if (is_half) {
+                    if (std::abs(x) > half_max + 16.0) {
+                        ok = std::isinf(y) && std::signbit(y) == std::signbit(x);
+                    } else {
+                        // 10 mantissa bits, and no more than the spacing of
+                        // the half denormals near zero
+                        ok = std::abs(y-x) <= roundoff(x, 11, std::ldexp(Real(1.0),-14));
+                    }
+                } else {
+                    if (std::abs(x) > float_max) {
+                        ok = std::isinf(y) && std::signbit(y) == std::signbit(x);
+                    } else {
+                        ok = y == static_cast<Real>(static_cast<float>(x));
+                    }
+                }
+                if (!ok) {
+                    if (nfail < 10) {
+                        amrex::AllPrint() << "  " << name << ": " << x << " read back as "
+                                          << y << "\n";
+                    }
+                    ++nfail;
+                }
+            });
+        }
+        ParallelDescriptor::ReduceLongSum(nfail);
+        if (nfail > 0) {
+            amrex::Abort(name + ": " + std::to_string(nfail) + " values out of tolerance");
+        }
+        amrex::Print() << "  " << name << " passed\n";
+    }
+}
+
+namespace {
+
+// A linear function, so that averages over cells equal the values at the
+// cell centers and every product can be checked against it
+Real linearValue (const RealVect& x, int comp)
+{
+    return (comp+1) * (1.0 + AMREX_D_TERM(x[0], + 2.0*x[1], + 3.0*x[2]));
+}
+
+// Checks that the product plotfile name has the expected problem domain
+// and covered region on every level, and that component comp of the
+// original data was written as variable varname at the right positions.
+void checkProduct (const std::string& name, const Vector<Box>& domain, const Vector<Box>& covered,
+                   const RealBox& prob, const std::string& varname, int comp)
+{
+    PlotFileData pf(name);
+    AMREX_ALWAYS_ASSERT(pf.finestLevel()+1 == int(domain.size()));
+    AMREX_ALWAYS_ASSERT(pf.nComp() == 1 && pf.varNames()[0] == varname);
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        AMREX_ALWAYS_ASSERT(std::abs(pf.probLo()[d] - prob.lo(d)) < 1.e-12);
+        AMREX_ALWAYS_ASSERT(std::abs(pf.probHi()[d] - prob.hi(d)) < 1.e-12);
+    }
+
+    Long nfail = 0;
+    for (int lev = 0; lev <= pf.finestLevel(); ++lev)
+    {
+        AMREX_ALWAYS_ASSERT(pf.probDomain(lev) == domain[lev]);
+        AMREX_ALWAYS_ASSERT(pf.boxArray(lev).minimalBox() == covered[lev]);
+        AMREX_ALWAYS_ASSERT(pf.boxArray(lev).numPts() == covered[lev].numPts());
+
+        const auto dx = pf.cellSize(lev);
+        const IntVect lo = domain[lev].smallEnd();
+        MultiFab mf = pf.get(lev, varname);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            Array4<Real const> const& a = mf.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                RealVect x;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    x[d] = prob.lo(d) + (iv[d] - lo[d] + 0.5) * dx[d];
+                }
+                if (std::abs(a(i,j,k) - linearValue(x,comp)) > 1.e-12) {
+                    if (nfail < 10) {
+                        amrex::AllPrint() << "  " << name << ": level " << lev << " cell " << iv
+                                          << " is " << a(i,j,k) << ", expected "
+                                          << linearValue(x,comp) << "\n";
+                    }
+                    ++nfail;
+                }
+            });
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nfail);
+    if (nfail > 0) {
+        amrex::Abort(name + ": " + std::to_string(nfail) + " wrong values");
+    }
+    amrex::Print() << "  " << name << " passed\n";
+}
+
+}
+
+void testProducts (const TestParams& params)
+{
+    const int nlevels = 2;
+    const IntVect rr(2);
+    const int n = params.n_cell;
+
+    Vector<Geometry> geom(nlevels);
+    Vector<BoxArray> ba(nlevels);
+    Vector<MultiFab> mf(nlevels);
+    geom[0] = makeGeometry(params);
+    geom[1] = Geometry(amrex::refine(geom[0].Domain(), rr), geom[0].ProbDomain(), 0,
+                       geom[0].isPeriodic());
+    ba[0] = BoxArray(geom[0].Domain());
+    ba[1] = BoxArray(amrex::refine(Box(IntVect(n/4), IntVect(3*n/4-1)), rr));
+
+    const int ncomp = 2;
+    for (int lev = 0; lev < nlevels; ++lev) {
+        ba[lev].maxSize(params.max_grid_size);
+        mf[lev].define(ba[lev], DistributionMapping(ba[lev]), ncomp, 0);
+        for (MFIter mfi(mf[lev]); mfi.isValid(); ++mfi) {
+            Array4<Real> const& a = mf[lev].array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int c) {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                RealVect x;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    x[d] = geom[lev].ProbLo(d) + (iv[d] + 0.5) * geom[lev].CellSize(d);
+                }
+                a(i,j,k,c) = linearValue(x,c);
+            });
+        }
+    }
+
+    const Real z = 0.51;
+    const RealBox region({AMREX_D_DECL(0.2,0.3,0.1)}, {AMREX_D_DECL(0.6,0.7,0.9)});
+
+    Vector<PlotFileProduct> products;
+    products.push_back(PlotFileProduct::Coarsened("plt_coarsened", rr, {"b"}));
+    products.push_back(PlotFileProduct::Slice("plt_slice", AMREX_SPACEDIM-1, z, {"a"}));
+    products.push_back(PlotFileProduct::SubBox("plt_subbox", region, {"b"}));
+
+    WriteMultiLevelPlotfileProducts(nlevels, GetVecOfConstPtrs(mf), {"a", "b"}, geom, 0.0,
+                                    {0, 0}, {rr}, products);
+
+    // coarsened by 2 on both levels
+    {
+        Vector<Box> domain{amrex::coarsen(geom[0].Domain(), rr),
+                           amrex::coarsen(geom[1].Domain(), rr)};
+        Vector<Box> covered{amrex::coarsen(ba[0].minimalBox(), rr),
+                            amrex::coarsen(ba[1].minimalBox(), rr)};
+        checkProduct("plt_coarsened", domain, covered, geom[0].ProbDomain(), "b", 1);
+    }
+
+    // the level 0 cells containing the plane, and the fine cells under them
+    {
+        const int dir = AMREX_SPACEDIM-1;
+        const int islice = static_cast<int>(std::floor(z*n));
+        Box slice0 = geom[0].Domain();
+        slice0.setSmall(dir, islice);
+        slice0.setBig(dir, islice);
+        const Box slice1 = amrex::refine(slice0, rr);
+        RealBox prob = geom[0].ProbDomain();
+        prob.setLo(dir, Real(islice)/n);
+        prob.setHi(dir, Real(islice+1)/n);
+        checkProduct("plt_slice", {slice0, slice1}, {slice0, slice1 & ba[1].minimalBox()},
+                     prob, "a", 0);
+    }
+
+    // the level 0 cells covering the region, and the fine cells under them
+    {
+        IntVect lo, hi;
+        RealBox prob;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            lo[d] = static_cast<int>(std::floor(region.lo(d)*n));
+            hi[d] = static_cast<int>(std::ceil(region.hi(d)*n)) - 1;
+            prob.setLo(d, Real(lo[d])/n);
+            prob.setHi(d, Real(hi[d]+1)/n);
+        }
+        const Box sub0(lo, hi);
+        const Box sub1 = amrex::refine(sub0, rr);
+        checkProduct("plt_subbox", {sub0, sub1}, {sub0, sub1 & ba[1].minimalBox()},
+                     prob, "b", 1);
+    }
+}
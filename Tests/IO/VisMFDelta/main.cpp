@@ -0,0 +1,127 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+struct TestParams
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+};
+
+void testWriteDelta (const TestParams& params);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    TestParams params;
+    {
+        ParmParse pp;
+        pp.query("n_cell", params.n_cell);
+        pp.query("max_grid_size", params.max_grid_size);
+    }
+
+    amrex::Print() << "Running VisMF::WriteDelta test \n";
+    testWriteDelta(params);
+
+    amrex::Finalize();
+}
+
+namespace {
+
+// Reads name back with VisMF::Read and checks that it is bitwise equal to
+// mf, including the ghost cells.
+void checkReadBack (const MultiFab& mf, const std::string& name)
+{
+    MultiFab mf2(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrow());
+    mf2.setVal(-1.0);
+    VisMF::Read(mf2, name);
+
+    Long ndiff = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const FArrayBox& a = mf[mfi];
+        const FArrayBox& b = mf2[mfi];
+        if (std::memcmp(a.dataPtr(), b.dataPtr(), a.nBytes()) != 0) ++ndiff;
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    if (ndiff > 0) {
+        amrex::Abort(name + ": " + std::to_string(ndiff) + " fabs differ after VisMF::Read");
+    }
+}
+
+}
+
+void testWriteDelta (const TestParams& params)
+{
+    BoxArray ba(Box(IntVect(0), IntVect(params.n_cell-1)));
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncomp = 2;
+    const int nghost = 1;
+    MultiFab mf(ba, dm, ncomp, nghost);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n) {
+            a(i,j,k,n) = std::sin(0.1*i + 0.2*j + 0.3*k + n);
+        });
+    }
+
+    // a full write
+    Long bytes0 = VisMF::WriteDelta(mf, "delta_0", "");
+    checkReadBack(mf, "delta_0");
+
+    // change every third fab, and one value in another fab by one ulp
+    Long nchanged = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const int idx = mfi.index();
+        if (idx % 3 == 0) {
+            mf[mfi].plus<RunOn::Host>(1.0);
+            ++nchanged;
+        } else if (idx == 1) {
+            Real* p = mf[mfi].dataPtr(1) + 5;
+            *p = std::nextafter(*p, Real(2.0));
+            ++nchanged;
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nchanged);
+
+    Long bytes1 = VisMF::WriteDelta(mf, "delta_1", "delta_0");
+    checkReadBack(mf, "delta_1");
+
+    // nothing changed, all the data is in the two earlier files
+    Long bytes2 = VisMF::WriteDelta(mf, "delta_2", "delta_1");
+    checkReadBack(mf, "delta_2");
+
+    // a change back to data written in the first file is written again,
+    // since only the prior write is compared
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        if (mfi.index() % 3 == 0) {
+            mf[mfi].minus<RunOn::Host>(1.0);
+        }
+    }
+    Long bytes3 = VisMF::WriteDelta(mf, "delta_3", "delta_2");
+    checkReadBack(mf, "delta_3");
+
+    ParallelDescriptor::ReduceLongSum(bytes0);
+    ParallelDescriptor::ReduceLongSum(bytes1);
+    ParallelDescriptor::ReduceLongSum(bytes2);
+    ParallelDescriptor::ReduceLongSum(bytes3);
+
+    const Long fab_bytes = amrex::grow(ba[0], nghost).numPts() * ncomp * sizeof(Real);
+    amrex::Print() << "  bytes written: " << bytes0 << " " << bytes1 << " "
+                   << bytes2 << " " << bytes3 << "\n";
+
+    // the fab headers are small compared with the data
+    AMREX_ALWAYS_ASSERT(bytes0 >= mf.size()*fab_bytes);
+    AMREX_ALWAYS_ASSERT(bytes1 >= nchanged*fab_bytes && bytes1 < (nchanged+1)*fab_bytes);
+    AMREX_ALWAYS_ASSERT(bytes2 < fab_bytes);
+    AMREX_ALWAYS_ASSERT(bytes3 >= (nchanged-1)*fab_bytes && bytes3 < nchanged*fab_bytes);
+
+    amrex::Print() << "  passed\n";
+}
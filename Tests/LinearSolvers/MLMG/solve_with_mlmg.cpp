@@ -1,9 +1,15 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_MLMG.H>
+#include <AMReX_MLFGMRES.H>
 #include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLNodeLaplacian.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParmParse.H>
 
+#include <algorithm>
+#include <cmath>
+
 #include <prob_par.H>
 
 using namespace amrex;
@@ -20,6 +26,410 @@ static int linop_maxorder = 2;
 static bool agglomeration = false;
 static bool consolidation = false;
 static int  use_hypre = 0;
+static int smooth_sweeps_per_fill = 1;
+static int chebyshev_degree = 0;
+static bool check_multismooth = false;
+static bool check_mixed_precision = false;
+static std::string linop_type = "abeclap";
+static std::string bottom_solver = "default";
+static int bottom_sstep = 4;
+static Vector<std::string> check_bottom_solvers;
+static bool check_sstep_breakdown = false;
+static bool check_fgmres = false;
+
+MLMG::BottomSolver bottom_solver_type (const std::string& name)
+{
+  if (name == "default")      return MLMG::BottomSolver::Default;
+  if (name == "smoother")     return MLMG::BottomSolver::smoother;
+  if (name == "bicgstab")     return MLMG::BottomSolver::bicgstab;
+  if (name == "cg")           return MLMG::BottomSolver::cg;
+  if (name == "bicgcg")       return MLMG::BottomSolver::bicgcg;
+  if (name == "cgbicg")       return MLMG::BottomSolver::cgbicg;
+  if (name == "hypre")        return MLMG::BottomSolver::hypre;
+  if (name == "petsc")        return MLMG::BottomSolver::petsc;
+  if (name == "pipebicgstab") return MLMG::BottomSolver::pipebicgstab;
+  if (name == "pipecg")       return MLMG::BottomSolver::pipecg;
+  if (name == "sstepcg")      return MLMG::BottomSolver::sstepcg;
+  if (name == "direct")       return MLMG::BottomSolver::direct;
+  if (name == "fft")          return MLMG::BottomSolver::fft;
+  amrex::Abort("Unknown bottom_solver " + name);
+  return MLMG::BottomSolver::Default;
+}
+
+void setup_mlmg (MLMG& mlmg)
+{
+  mlmg.setMaxIter(max_iter);
+  mlmg.setMaxFmgIter(max_fmg_iter);
+  mlmg.setSmoothSweepsPerFill(smooth_sweeps_per_fill);
+  if (use_hypre) {
+    mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
+  } else {
+    mlmg.setBottomSolver(bottom_solver_type(bottom_solver));
+  }
+  mlmg.setBottomSStep(bottom_sstep);
+  mlmg.setVerbose(verbose);
+  mlmg.setBottomVerbose(bottom_verbose);
+}
+
+Vector<MultiFab> copy_of (const Vector<MultiFab>& mf)
+{
+  Vector<MultiFab> r(mf.size());
+  for (int ilev = 0; ilev < mf.size(); ++ilev) {
+    r[ilev].define(mf[ilev].boxArray(), mf[ilev].DistributionMap(), 1, mf[ilev].nGrow());
+    MultiFab::Copy(r[ilev], mf[ilev], 0, 0, 1, mf[ilev].nGrow());
+  }
+  return r;
+}
+
+// Solves the Poisson equation with the rhs of the ABecLaplacian problem.
+// Returns the iterations of the bottom solves.
+Vector<int> solve_poisson (const Vector<Geometry>& geom, const LPInfo& info,
+                    Vector<MultiFab>& soln, const Vector<MultiFab>& rhs,
+                    Real tol_rel, Real tol_abs, bool mixed_precision = false)
+{
+  const int nlevels = geom.size();
+  Vector<BoxArray> grids;
+  Vector<DistributionMapping> dmap;
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    grids.push_back(soln[ilev].boxArray());
+    dmap.push_back(soln[ilev].DistributionMap());
+  }
+
+  MLPoisson mlpoisson(geom, grids, dmap, info);
+  mlpoisson.setMaxOrder(linop_maxorder);
+  if (chebyshev_degree > 0) mlpoisson.setChebyshevSmoother(true, chebyshev_degree);
+  mlpoisson.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
+                        {prob::bc_type, prob::bc_type, prob::bc_type});
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    mlpoisson.setLevelBC(ilev, &soln[ilev]);
+  }
+
+  MLMG mlmg(mlpoisson);
+  setup_mlmg(mlmg);
+  mlmg.setMixedPrecision(mixed_precision);
+  mlmg.solve(GetVecOfPtrs(soln), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+  return mlmg.getNumCGIters();
+}
+
+// Solves the Poisson problem with the double and with the single precision
+// V-cycles and checks that the two solutions agree to the solver tolerance
+void compare_mixed_precision (const Vector<Geometry>& geom, const LPInfo& info,
+                              Vector<MultiFab>& soln, const Vector<MultiFab>& rhs,
+                              Real tol_rel, Real tol_abs)
+{
+  const int nlevels = geom.size();
+  Vector<MultiFab> soln_sp = copy_of(soln);
+
+  Real t0 = amrex::second();
+  solve_poisson(geom, info, soln, rhs, tol_rel, tol_abs);
+  Real t_dp = amrex::second() - t0;
+  t0 = amrex::second();
+  solve_poisson(geom, info, soln_sp, rhs, tol_rel, tol_abs, true);
+  Real t_sp = amrex::second() - t0;
+
+  ParallelDescriptor::ReduceRealMax(t_dp);
+  ParallelDescriptor::ReduceRealMax(t_sp);
+  amrex::Print() << "Solve time with double V-cycles: " << t_dp
+                 << ", with single precision V-cycles: " << t_sp << "\n";
+
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    const Real scale = soln[ilev].norm0();
+    MultiFab::Subtract(soln_sp[ilev], soln[ilev], 0, 0, 1, 0);
+    const Real diff = soln_sp[ilev].norm0();
+    amrex::Print() << "Level " << ilev << ": max difference of the mixed precision solution "
+                   << diff << ", max of the solution " << scale << "\n";
+    AMREX_ALWAYS_ASSERT(diff <= 10.*tol_rel*scale);
+  }
+}
+
+// Solves the nodal Laplacian with sigma = beta and a product of sines as
+// the rhs.  The solution is averaged to the cell centers into soln.
+// Returns the iterations of the bottom solves.
+Vector<int> solve_nodal (const Vector<Geometry>& geom, const LPInfo& info,
+                  Vector<MultiFab>& soln, const Vector<MultiFab>& beta,
+                  Real tol_rel, Real tol_abs)
+{
+  const int nlevels = geom.size();
+  Vector<BoxArray> grids;
+  Vector<DistributionMapping> dmap;
+  Vector<MultiFab> phi(nlevels);
+  Vector<MultiFab> rhs(nlevels);
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    grids.push_back(soln[ilev].boxArray());
+    dmap.push_back(soln[ilev].DistributionMap());
+    const BoxArray& nba = amrex::convert(grids[ilev], IntVect::TheNodeVector());
+    phi[ilev].define(nba, dmap[ilev], 1, 1);
+    rhs[ilev].define(nba, dmap[ilev], 1, 0);
+    phi[ilev].setVal(0.0);
+
+    const auto problo = geom[ilev].ProbLoArray();
+    const auto dx = geom[ilev].CellSizeArray();
+    for (MFIter mfi(rhs[ilev]); mfi.isValid(); ++mfi) {
+      const Box& bx = mfi.validbox();
+      const auto& r = rhs[ilev].array(mfi);
+      amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+      {
+        constexpr Real tpi = 2.0*3.14159265358979323846;
+        r(i,j,k) = std::sin(tpi*(problo[0]+i*dx[0]))
+                 * std::sin(tpi*(problo[1]+j*dx[1]))
+                 * std::sin(tpi*(problo[2]+k*dx[2]));
+      });
+    }
+  }
+
+  MLNodeLaplacian mlndlap(geom, grids, dmap, info);
+  if (chebyshev_degree > 0) mlndlap.setChebyshevSmoother(true, chebyshev_degree);
+  mlndlap.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
+                      {prob::bc_type, prob::bc_type, prob::bc_type});
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    mlndlap.setSigma(ilev, beta[ilev]);
+  }
+
+  MLMG mlmg(mlndlap);
+  setup_mlmg(mlmg);
+  mlmg.solve(GetVecOfPtrs(phi), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    amrex::average_node_to_cellcenter(soln[ilev], 0, phi[ilev], 0, 1);
+  }
+  return mlmg.getNumCGIters();
+}
+
+// Whether the bottom solver factorizes or transforms the bottom operator
+// instead of iterating, so that MLMG records no bottom solves for it.
+// Without SWFFT the FFT solver falls back to bicgstab.
+bool is_direct_bottom_solver (const std::string& name)
+{
+#ifdef AMREX_USE_SWFFT
+  if (name == "fft") return true;
+#endif
+  return name == "direct";
+}
+
+// Solves with the bicgstab bottom solver and then with each of
+// check_bottom_solvers from the same initial guess, and checks that the
+// solutions agree to the solver tolerance.  solve(soln, info) returns the
+// iterations of the bottom solves.
+template <typename F>
+void compare_bottom_solvers (Vector<MultiFab>& soln, const LPInfo& info, Real tol_rel, F&& solve)
+{
+  const int nlevels = soln.size();
+  const Vector<MultiFab> soln0 = copy_of(soln);
+
+  auto check = [&] (const std::string& name, Vector<MultiFab>& x, const Vector<int>& iters) {
+    Long nsolves = iters.size();
+    Long niters = 0;
+    for (int n : iters) niters += n;
+    ParallelDescriptor::ReduceLongMax(nsolves);
+    ParallelDescriptor::ReduceLongMax(niters);
+    amrex::Print() << "Bottom solver " << name << ": " << nsolves << " bottom solves, "
+                   << niters << " iterations\n";
+    // A direct solver that fell back to bicgstab has iterated
+    AMREX_ALWAYS_ASSERT((nsolves == 0) == is_direct_bottom_solver(name));
+    // The solution of a singular problem is unique up to a constant
+    if (prob::bc_type == MLLinOp::BCType::Periodic) {
+      const Real offset = (x[0].sum() - soln[0].sum()) / x[0].boxArray().d_numPts();
+      for (auto& mf : x) mf.plus(-offset, 0, 1, 0);
+    }
+    for (int ilev = 0; ilev < nlevels; ++ilev) {
+      const Real scale = soln[ilev].norm0();
+      MultiFab::Subtract(x[ilev], soln[ilev], 0, 0, 1, 0);
+      const Real diff = x[ilev].norm0();
+      amrex::Print() << "  level " << ilev << ": max difference from bicgstab " << diff << "\n";
+      AMREX_ALWAYS_ASSERT(diff <= 10.*tol_rel*scale);
+    }
+  };
+
+  bottom_solver = "bicgstab";
+  solve(soln, info);
+
+  for (const auto& name : check_bottom_solvers) {
+    Vector<MultiFab> x = copy_of(soln0);
+    bottom_solver = name;
+    const Vector<int> iters = solve(x, info);
+    check(name, x, iters);
+  }
+}
+
+// Solves the Poisson equation with a constant rhs and zero Dirichlet
+// values on AMR level 0 down to the 2x2x2 bottom.  The boxes are laid out
+// symmetrically, so the bottom residual is constant, which is an
+// eigenvector of the bottom operator.  The monomial basis of s-step CG then
+// has rank one and the solver breaks down.  MLMG has to fall back to
+// smoothing the bottom and still converge to the bicgstab solution.
+void check_sstep_cg_breakdown (const Geometry& geom, const BoxArray& grids,
+                               const DistributionMapping& dmap, Real tol_rel, Real tol_abs)
+{
+  MultiFab rhs(grids, dmap, 1, 0);
+  rhs.setVal(1.0);
+
+  auto solve = [&] (MultiFab& x) {
+    x.define(grids, dmap, 1, 1);
+    x.setVal(0.0);
+    MLPoisson mlpoisson({geom}, {grids}, {dmap});
+    mlpoisson.setMaxOrder(linop_maxorder);
+    mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet, LinOpBCType::Dirichlet, LinOpBCType::Dirichlet)},
+                          {AMREX_D_DECL(LinOpBCType::Dirichlet, LinOpBCType::Dirichlet, LinOpBCType::Dirichlet)});
+    mlpoisson.setLevelBC(0, &x);
+    MLMG mlmg(mlpoisson);
+    setup_mlmg(mlmg);
+    mlmg.solve({&x}, {&rhs}, tol_rel, tol_abs);
+    return mlmg.getNumCGIters();
+  };
+
+  const std::string bottom_solver_0 = bottom_solver;
+  const int bottom_sstep_0 = bottom_sstep;
+
+  MultiFab x0, x;
+  bottom_solver = "bicgstab";
+  solve(x0);
+  bottom_solver = "sstepcg";
+  bottom_sstep = 8;
+  const Vector<int> iters = solve(x);
+
+  bottom_solver = bottom_solver_0;
+  bottom_sstep = bottom_sstep_0;
+
+  // A broken down bottom solve reports no iterations.  The bottom may be
+  // solved on a subset of the ranks.
+  Long nbreakdown = std::count(iters.begin(), iters.end(), 0);
+  Long nsolves = iters.size();
+  ParallelDescriptor::ReduceLongMax(nbreakdown);
+  ParallelDescriptor::ReduceLongMax(nsolves);
+  amrex::Print() << "s-step CG broke down in " << nbreakdown << " of "
+                 << nsolves << " bottom solves\n";
+  AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nbreakdown > 0, "s-step CG did not break down");
+
+  const Real scale = x0.norm0();
+  MultiFab::Subtract(x, x0, 0, 0, 1, 0);
+  const Real diff = x.norm0();
+  amrex::Print() << "  max difference from bicgstab " << diff << "\n";
+  AMREX_ALWAYS_ASSERT(diff <= 10.*tol_rel*scale);
+}
+
+// The 2-norm over the cells not covered by a finer level
+Real composite_norm2 (const Vector<MultiFab const*>& v, int ref_ratio)
+{
+  const int nlevels = v.size();
+  Real r = 0.0;
+  for (int ilev = 0; ilev < nlevels; ++ilev) {
+    if (ilev < nlevels-1) {
+      const iMultiFab mask = makeFineMask(*v[ilev], v[ilev+1]->boxArray(), IntVect(ref_ratio), 1, 0);
+      r += MultiFab::Dot(mask, *v[ilev], 0, *v[ilev], 0, 1, 0, true);
+    } else {
+      r += MultiFab::Dot(*v[ilev], 0, *v[ilev], 0, 1, 0, true);
+    }
+  }
+  ParallelDescriptor::ReduceRealSum(r);
+  return std::sqrt(r);
+}
+
+// The composite 2-norm of rhs - L(x)
+Real composite_residual_norm (MLMG& mlmg, int ref_ratio, const Vector<MultiFab*>& x,
+                              const Vector<MultiFab const*>& rhs)
+{
+  Vector<MultiFab> res(x.size());
+  for (int ilev = 0; ilev < x.size(); ++ilev) {
+    res[ilev].define(rhs[ilev]->boxArray(), rhs[ilev]->DistributionMap(), 1, 0);
+  }
+  mlmg.compResidual(GetVecOfPtrs(res), x, rhs);
+  return composite_norm2(GetVecOfConstPtrs(res), ref_ratio);
+}
+
+// Solves the Poisson problem with MLFGMRES on AMR level 0 alone and on all
+// the levels, with each of the orthogonalizations, and checks that the
+// composite residual meets the tolerance.
+void check_fgmres_residuals (const Vector<Geometry>& geom, int ref_ratio, const LPInfo& info,
+                             const Vector<MultiFab>& soln, const Vector<MultiFab>& rhs,
+                             Real tol_rel, Real tol_abs)
+{
+  const std::pair<MLFGMRES::Orthogonalization, std::string> orthogonalizations[] = {
+    {MLFGMRES::Orthogonalization::MGS,  "MGS"},
+    {MLFGMRES::Orthogonalization::CGS,  "CGS"},
+    {MLFGMRES::Orthogonalization::CGS2, "CGS2"}};
+
+  Vector<int> nlevels{1};
+  if (geom.size() > 1) nlevels.push_back(geom.size());
+
+  for (int nlev : nlevels) {
+    for (const auto& o : orthogonalizations) {
+      Vector<MultiFab> x = copy_of(soln);
+      x.resize(nlev);
+      const Vector<Geometry> xgeom(geom.begin(), geom.begin()+nlev);
+      Vector<BoxArray> grids;
+      Vector<DistributionMapping> dmap;
+      Vector<MultiFab const*> prhs;
+      for (int ilev = 0; ilev < nlev; ++ilev) {
+        grids.push_back(x[ilev].boxArray());
+        dmap.push_back(x[ilev].DistributionMap());
+        prhs.push_back(&rhs[ilev]);
+      }
+
+      MLPoisson mlpoisson(xgeom, grids, dmap, info);
+      mlpoisson.setMaxOrder(linop_maxorder);
+      mlpoisson.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
+                            {prob::bc_type, prob::bc_type, prob::bc_type});
+      for (int ilev = 0; ilev < nlev; ++ilev) {
+        mlpoisson.setLevelBC(ilev, &x[ilev]);
+      }
+
+      MLMG mlmg(mlpoisson);
+      setup_mlmg(mlmg);
+      MLFGMRES fgmres(mlmg);
+      fgmres.setVerbose(verbose);
+      fgmres.setMaxIter(max_iter);
+      fgmres.setOrthogonalization(o.first);
+
+      // The target of MLFGMRES
+      const Real bnorm = composite_norm2(prhs, ref_ratio);
+      const Real resnorm0 = composite_residual_norm(mlmg, ref_ratio, GetVecOfPtrs(x), prhs);
+      const Real target = std::max(tol_abs, tol_rel*std::max(bnorm, resnorm0));
+
+      fgmres.solve(GetVecOfPtrs(x), prhs, tol_rel, tol_abs);
+
+      const Real resnorm = composite_residual_norm(mlmg, ref_ratio, GetVecOfPtrs(x), prhs);
+      amrex::Print() << "MLFGMRES with " << o.second << " on "
+                     << (nlev == 1 ? std::string("one level") : std::to_string(nlev) + " levels") << ": "
+                     << fgmres.getNumIters() << " iterations, composite residual "
+                     << resnorm << ", target " << target << "\n";
+      AMREX_ALWAYS_ASSERT(resnorm <= target);
+    }
+  }
+}
+
+// Compares multiSmooth with the same number of smooth calls on AMR level 0,
+// starting from zero, and prints the time both take.
+void compare_multismooth (const MLLinOp& linop, const MultiFab& rhs)
+{
+  for (int nsweeps = 2; nsweeps <= 3; ++nsweeps) {
+    MultiFab a(rhs.boxArray(), rhs.DistributionMap(), 1, 1);
+    MultiFab b(rhs.boxArray(), rhs.DistributionMap(), 1, 1);
+    a.setVal(0.0);
+    b.setVal(0.0);
+
+    Real t0 = amrex::second();
+    for (int i = 0; i < nsweeps; ++i) {
+      linop.smooth(0, 0, a, rhs);
+    }
+    Real t_smooth = amrex::second() - t0;
+
+    t0 = amrex::second();
+    linop.multiSmooth(0, 0, b, rhs, nsweeps);
+    Real t_multi = amrex::second() - t0;
+
+    ParallelDescriptor::ReduceRealMax(t_smooth);
+    ParallelDescriptor::ReduceRealMax(t_multi);
+
+    const Real scale = a.norminf(0, 0);
+    MultiFab::Subtract(b, a, 0, 0, 1, 0);
+    const Real diff = b.norminf(0, 0);
+
+    amrex::Print() << "multiSmooth with " << nsweeps << " sweeps: relative difference "
+                   << diff/scale << ", time " << t_multi << " against "
+                   << t_smooth << " for smooth\n";
+    AMREX_ALWAYS_ASSERT(diff <= 1.e-12*scale);
+  }
+}
 }
 
 void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
@@ -44,6 +454,16 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     pp.query("agglomeration", agglomeration);
     pp.query("consolidation", consolidation);
     pp.query("use_hypre", use_hypre);
+    pp.query("smooth_sweeps_per_fill", smooth_sweeps_per_fill);
+    pp.query("chebyshev_degree", chebyshev_degree);
+    pp.query("check_multismooth", check_multismooth);
+    pp.query("check_mixed_precision", check_mixed_precision);
+    pp.query("bottom_solver", bottom_solver);
+    pp.query("bottom_sstep", bottom_sstep);
+    pp.queryarr("check_bottom_solvers", check_bottom_solvers);
+    pp.query("check_sstep_breakdown", check_sstep_breakdown);
+    pp.query("check_fgmres", check_fgmres);
+    pp.query("linop", linop_type);
     pp.query("tol_rel", tol_rel);
     pp.query("tol_abs", tol_abs);
   }
@@ -55,6 +475,38 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
 
   const int nlevels = geom.size();
 
+  if (linop_type == "poisson" || linop_type == "nodal") {
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(composite_solve, "Only the ABecLaplacian solves level by level");
+    const bool check_bottom = !check_bottom_solvers.empty() || check_sstep_breakdown;
+    if (linop_type == "poisson") {
+      if (check_mixed_precision) {
+        compare_mixed_precision(geom, info, soln, rhs, tol_rel, tol_abs);
+      } else if (check_fgmres) {
+        check_fgmres_residuals(geom, ref_ratio, info, soln, rhs, tol_rel, tol_abs);
+      } else if (check_bottom) {
+        compare_bottom_solvers(soln, info, tol_rel, [&] (Vector<MultiFab>& x, const LPInfo& xinfo) {
+          return solve_poisson(geom, xinfo, x, rhs, tol_rel, tol_abs);
+        });
+        if (check_sstep_breakdown) {
+          check_sstep_cg_breakdown(geom[0], soln[0].boxArray(), soln[0].DistributionMap(),
+                                   tol_rel, tol_abs);
+        }
+      } else {
+        solve_poisson(geom, info, soln, rhs, tol_rel, tol_abs);
+      }
+    } else {
+      if (check_bottom) {
+        compare_bottom_solvers(soln, info, tol_rel, [&] (Vector<MultiFab>& x, const LPInfo& xinfo) {
+          return solve_nodal(geom, xinfo, x, beta, tol_rel, tol_abs);
+        });
+      } else {
+        solve_nodal(geom, info, soln, beta, tol_rel, tol_abs);
+      }
+    }
+    return;
+  }
+  AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop_type == "abeclap", "linop must be abeclap, poisson or nodal");
+
   if (composite_solve) {
     Vector<BoxArray> grids;
     Vector<DistributionMapping> dmap;
@@ -69,6 +521,7 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
 
     MLABecLaplacian mlabec(geom, grids, dmap, info);
     mlabec.setMaxOrder(linop_maxorder);
+    if (chebyshev_degree > 0) mlabec.setChebyshevSmoother(true, chebyshev_degree);
     // BC
     mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
                        {prob::bc_type, prob::bc_type, prob::bc_type});
@@ -90,13 +543,11 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
     }
 
     MLMG mlmg(mlabec);
-    mlmg.setMaxIter(max_iter);
-    mlmg.setMaxFmgIter(max_fmg_iter);
-    if (use_hypre) mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
-    mlmg.setVerbose(verbose);
-    mlmg.setBottomVerbose(bottom_verbose);
+    setup_mlmg(mlmg);
 
     mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+
+    if (check_multismooth) compare_multismooth(mlabec, rhs[0]);
   } else {
     const int levbegin = (fine_leve_solve_only) ? nlevels-1 : 0;
     for (int ilev = 0; ilev < levbegin; ++ilev) {
@@ -110,6 +561,7 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
                              info);
 
       mlabec.setMaxOrder(linop_maxorder);
+      if (chebyshev_degree > 0) mlabec.setChebyshevSmoother(true, chebyshev_degree);
 
       mlabec.setDomainBC({prob::bc_type, prob::bc_type, prob::bc_type},
                          {prob::bc_type, prob::bc_type, prob::bc_type});
@@ -133,10 +585,7 @@ void solve_with_mlmg(const Vector<Geometry>& geom, int ref_ratio,
       mlabec.setBCoeffs(solver_level, amrex::GetArrOfConstPtrs(bcoefs));
 
       MLMG mlmg(mlabec);
-      mlmg.setMaxIter(max_iter);
-      mlmg.setMaxFmgIter(max_fmg_iter);
-      mlmg.setVerbose(verbose);
-      mlmg.setBottomVerbose(bottom_verbose);
+      setup_mlmg(mlmg);
 
       mlmg.solve({&soln[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
     }
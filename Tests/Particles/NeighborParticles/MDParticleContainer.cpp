@@ -431,6 +431,94 @@ void MDParticleContainer::checkNeighborList()
     amrex::PrintToFile("neighbor_test") << "All the neighbor list particles match!" << std::endl;
 }
 
+void MDParticleContainer::checkHalfNeighborList()
+{
+    BL_PROFILE("MDParticleContainer::checkHalfNeighborList");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    // the number of neighbors of each particle in the full list
+    setHalfNeighborList(false);
+    buildNeighborList(CheckPair());
+
+    std::map<std::pair<int, int>, Vector<int> > full_counts;
+    Long num_full = 0;
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto index = std::make_pair(mfi.index(), mfi.LocalTileIndex());
+        auto& aos = plev[index].GetArrayOfStructs();
+        auto nbor_data = m_neighbor_list[lev][index].data();
+        auto& counts = full_counts[index];
+        for (int i = 0; i < aos.numParticles(); ++i)
+        {
+            int n = 0;
+            for (const auto& p2 : nbor_data.getNeighbors(i)) {
+                amrex::ignore_unused(p2);
+                ++n;
+            }
+            counts.push_back(n);
+            num_full += n;
+        }
+    }
+
+    // with the half list, count each pair on both particles, then sum the
+    // counts on the ghosts back to their owners
+    setHalfNeighborList(true);
+    buildNeighborList(CheckPair());
+
+    Long num_half = 0;
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto index = std::make_pair(mfi.index(), mfi.LocalTileIndex());
+        auto& aos = plev[index].GetArrayOfStructs();
+        for (int i = 0; i < aos.numTotalParticles(); ++i) {
+            aos[i].rdata(PIdx::ax) = 0.0;
+        }
+
+        auto nbor_data = m_neighbor_list[lev][index].data();
+        for (int i = 0; i < aos.numParticles(); ++i)
+        {
+            for (auto& p2 : nbor_data.getNeighbors(i))
+            {
+                aos[i].rdata(PIdx::ax) += 1.0;
+                p2.rdata(PIdx::ax) += 1.0;
+                ++num_half;
+            }
+        }
+    }
+
+    sumNeighbors(PIdx::ax, 1, 0, 0);
+
+    ParallelDescriptor::ReduceLongSum(num_full);
+    ParallelDescriptor::ReduceLongSum(num_half);
+    if (2*num_half != num_full)
+    {
+        amrex::PrintToFile("neighbor_test") << "Half list has " << num_half << " pairs, full list has "
+                                            << num_full << " entries" << std::endl;
+        amrex::Abort();
+    }
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto index = std::make_pair(mfi.index(), mfi.LocalTileIndex());
+        auto& aos = plev[index].GetArrayOfStructs();
+        const auto& counts = full_counts[index];
+        for (int i = 0; i < aos.numParticles(); ++i)
+        {
+            if (aos[i].rdata(PIdx::ax) != counts[i])
+            {
+                amrex::PrintToFile("neighbor_test") << "Half list count " << aos[i].rdata(PIdx::ax)
+                                                    << " does not match full list count " << counts[i]
+                                                    << " for particle " << i << std::endl;
+                amrex::Abort();
+            }
+        }
+    }
+
+    amrex::PrintToFile("neighbor_test") << "The half neighbor list matches the full list!" << std::endl;
+}
+
 void MDParticleContainer::reset_test_id()
 {
     BL_PROFILE("MDParticleContainer::reset_test_id");
@@ -22,6 +22,8 @@ void testNeighborParticles();
 
 void testNeighborList();
 
+void testHalfNeighborList();
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -32,6 +34,9 @@ int main (int argc, char* argv[])
     amrex::PrintToFile("neighbor_test") << "Running neighbor list test \n";
     testNeighborList();
 
+    amrex::PrintToFile("neighbor_test") << "Running half neighbor list test \n";
+    testHalfNeighborList();
+
     amrex::Finalize();
 }
 
@@ -183,4 +188,70 @@ void testNeighborList ()
     pc.buildNeighborList(CheckPair());
 
     pc.checkNeighborList();
+
+    // With a Verlet skin the list is only rebuilt once some particle has
+    // moved more than half the skin.  The shifts are exact in floating
+    // point, so the pair distances do not change.
+    const Real skin = 0.5;
+    const Real shift = 0.0625;
+
+    bool rebuilt = pc.buildNeighborListWithSkin(CheckPair(), skin);
+    AMREX_ALWAYS_ASSERT(rebuilt);
+
+    pc.moveParticles(shift);
+    rebuilt = pc.buildNeighborListWithSkin(CheckPair(), skin);
+    AMREX_ALWAYS_ASSERT(! rebuilt);
+    pc.checkNeighborList();
+
+    pc.moveParticles(shift);
+    rebuilt = pc.buildNeighborListWithSkin(CheckPair(), skin);
+    AMREX_ALWAYS_ASSERT(! rebuilt);
+    pc.checkNeighborList();
+
+    pc.moveParticles(shift);
+    rebuilt = pc.buildNeighborListWithSkin(CheckPair(), skin);
+    AMREX_ALWAYS_ASSERT(rebuilt);
+    pc.checkNeighborList();
+}
+
+void testHalfNeighborList ()
+{
+    BL_PROFILE("testHalfNeighborList");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = params.is_periodic;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = 1;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    // sumNeighbors needs the inverse tags
+    pc.setEnableInverse(true);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+
+    pc.InitParticles(nppc, 1.0, 0.0);
+    pc.fillNeighbors();
+
+    pc.checkHalfNeighborList();
 }
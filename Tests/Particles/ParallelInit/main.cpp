@@ -0,0 +1,217 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+#include <iomanip>
+#include <locale>
+
+using namespace amrex;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    Long num_particles;
+};
+
+void testParallelInit();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running parallel particle init test \n";
+    testParallelInit();
+
+    amrex::Finalize();
+}
+
+void get_test_params(TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_particles", params.num_particles);
+}
+
+static constexpr int NSR = 2;
+static constexpr int NAR = 1;
+static constexpr int extradata = NSR + NAR;
+
+using PC = ParticleContainer<NSR, 0, NAR, 0>;
+
+// Writes the same particles to an Ascii file in the format of InitFromAsciiFile
+// and to two binary files in the format of InitFromBinaryFile, the second one
+// with only the extra data that InitFromBinaryFile can read (NSR values).
+// Some of the particles are outside the periodic domain.
+void writeFiles (const TestParams& params, const std::string& ascii_file,
+                 const std::string& binary_file, const std::string& struct_binary_file)
+{
+    if (! ParallelDescriptor::IOProcessor()) return;
+
+    std::ofstream ofs(ascii_file);
+    std::ofstream bfs(binary_file, std::ios::binary);
+    std::ofstream sfs(struct_binary_file, std::ios::binary);
+
+    Long np = params.num_particles;
+    int dm = AMREX_SPACEDIM;
+    int nx = extradata;
+    int nsx = NSR;
+    bfs.write((char*)&np, sizeof(np));
+    bfs.write((char*)&dm, sizeof(dm));
+    bfs.write((char*)&nx, sizeof(nx));
+    sfs.write((char*)&np, sizeof(np));
+    sfs.write((char*)&dm, sizeof(dm));
+    sfs.write((char*)&nsx, sizeof(nsx));
+
+    ofs << np << "\n" << std::setprecision(17);
+    for (Long i = 0; i < np; ++i)
+    {
+        double v[AMREX_SPACEDIM + extradata];
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            v[d] = (1.2*amrex::Random() - 0.1) * params.size[d];
+        }
+        v[AMREX_SPACEDIM]   = static_cast<double>(i % 1000);
+        v[AMREX_SPACEDIM+1] = -1.0e-3 * amrex::Random();
+        v[AMREX_SPACEDIM+2] = 1.0e5 * amrex::Random();
+
+        for (int n = 0; n < AMREX_SPACEDIM + extradata; ++n) {
+            ofs << (n == 0 ? "" : "  ") << v[n];
+        }
+        ofs << "\n";
+        bfs.write((char*)v, sizeof(v));
+        sfs.write((char*)v, (AMREX_SPACEDIM + NSR)*sizeof(double));
+    }
+}
+
+// The sums of the positions and the first nextra extra data of the
+// particles in each grid, stored grid by grid
+Vector<Real> gridSums (const PC& pc, int nextra)
+{
+    constexpr int ncomp = AMREX_SPACEDIM + extradata;
+    Vector<Real> s(pc.ParticleBoxArray(0).size()*ncomp, 0.0);
+    for (const auto& kv : pc.GetParticles(0))
+    {
+        const int grid = kv.first.first;
+        const auto& aos = kv.second.GetArrayOfStructs();
+        const auto& soa = kv.second.GetStructOfArrays();
+        for (int i = 0; i < aos.numParticles(); ++i)
+        {
+            const auto& p = aos[i];
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) s[grid*ncomp+d] += p.pos(d);
+            for (int n = 0; n < NSR; ++n) s[grid*ncomp+AMREX_SPACEDIM+n] += p.rdata(n);
+            for (int n = 0; n < nextra-NSR; ++n) s[grid*ncomp+AMREX_SPACEDIM+NSR+n] += soa.GetRealData(n)[i];
+        }
+    }
+    ParallelAllReduce::Sum(s.data(), s.size(), ParallelContext::CommunicatorSub());
+    return s;
+}
+
+// Checks that pc has the same number of particles as ref in every grid, and
+// that the particles of each grid carry the same positions and first nextra
+// extra data
+void checkSame (const PC& ref, const PC& pc, int nextra,
+                const std::string& name, const std::string& refname)
+{
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == ref.TotalNumberOfParticles());
+
+    const auto nref = ref.NumberOfParticlesInGrid(0);
+    const auto n = pc.NumberOfParticlesInGrid(0);
+    AMREX_ALWAYS_ASSERT(n.size() == nref.size());
+    for (int grid = 0; grid < nref.size(); ++grid)
+    {
+        if (n[grid] != nref[grid]) {
+            amrex::Abort(name + ": grid " + std::to_string(grid) + " has " + std::to_string(n[grid])
+                         + " particles instead of " + std::to_string(nref[grid]));
+        }
+    }
+
+    const auto sref = gridSums(ref, nextra);
+    const auto s = gridSums(pc, nextra);
+    for (int i = 0; i < sref.size(); ++i)
+    {
+        AMREX_ALWAYS_ASSERT(std::abs(s[i] - sref[i]) <= 1.e-9 * (1.0 + std::abs(sref[i])));
+    }
+
+    amrex::Print() << name << " matches " << refname << " in all " << nref.size() << " grids \n";
+}
+
+// A decimal comma, so that any number parsed in the global locale goes wrong
+struct CommaPunct
+    : std::numpunct<char>
+{
+    char do_decimal_point () const override { return ','; }
+};
+
+void testParallelInit ()
+{
+    BL_PROFILE("testParallelInit");
+    TestParams params;
+    get_test_params(params, "init");
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[AMREX_SPACEDIM];
+    for (int i = 0; i < AMREX_SPACEDIM; i++)
+        is_per[i] = 1;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const std::string ascii_file = "parallel_init_particles.txt";
+    const std::string binary_file = "parallel_init_particles.bin";
+    const std::string struct_binary_file = "parallel_init_particles_struct.bin";
+    writeFiles(params, ascii_file, binary_file, struct_binary_file);
+    ParallelDescriptor::Barrier();
+
+    PC ref(geom, dm, ba);
+    Real t0 = amrex::second();
+    ref.InitFromAsciiFile(ascii_file, extradata);
+    Real t_ref = amrex::second() - t0;
+
+    AMREX_ALWAYS_ASSERT(ref.TotalNumberOfParticles() == params.num_particles);
+
+    // the parallel Ascii reader must not depend on the global locale
+    PC ascii(geom, dm, ba);
+    const std::locale old_locale = std::locale::global(std::locale(std::locale::classic(), new CommaPunct));
+    t0 = amrex::second();
+    ascii.InitFromAsciiFileParallel(ascii_file, extradata);
+    Real t_ascii = amrex::second() - t0;
+    std::locale::global(old_locale);
+    AMREX_ALWAYS_ASSERT(ascii.OK());
+    checkSame(ref, ascii, extradata, "InitFromAsciiFileParallel", "InitFromAsciiFile");
+
+    PC binary(geom, dm, ba);
+    t0 = amrex::second();
+    binary.InitFromBinaryFileParallel(binary_file, extradata);
+    Real t_binary = amrex::second() - t0;
+    AMREX_ALWAYS_ASSERT(binary.OK());
+    checkSame(ref, binary, extradata, "InitFromBinaryFileParallel", "InitFromAsciiFile");
+
+    // InitFromBinaryFile reads into the particle struct only
+    PC ref_binary(geom, dm, ba);
+    ref_binary.InitFromBinaryFile(struct_binary_file, NSR);
+    PC struct_binary(geom, dm, ba);
+    struct_binary.InitFromBinaryFileParallel(struct_binary_file, NSR);
+    AMREX_ALWAYS_ASSERT(struct_binary.OK());
+    checkSame(ref_binary, struct_binary, NSR, "InitFromBinaryFileParallel", "InitFromBinaryFile");
+
+    ParallelDescriptor::ReduceRealMax(t_ref);
+    ParallelDescriptor::ReduceRealMax(t_ascii);
+    ParallelDescriptor::ReduceRealMax(t_binary);
+    amrex::Print() << "InitFromAsciiFile time:          " << t_ref << "\n"
+                   << "InitFromAsciiFileParallel time:  " << t_ascii << "\n"
+                   << "InitFromBinaryFileParallel time: " << t_binary << "\n";
+}
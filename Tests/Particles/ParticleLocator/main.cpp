@@ -0,0 +1,159 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_cells;
+    int nrep;
+};
+
+void testLocator();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running particle locator test \n";
+    testLocator();
+
+    amrex::Finalize();
+}
+
+void get_test_params(TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_cells", params.num_cells);
+    pp.get("nrep", params.nrep);
+}
+
+template <class AssignGrid>
+Real locate (const AssignGrid& assign_grid, const Gpu::DeviceVector<IntVect>& cells,
+             Gpu::DeviceVector<int>& grids, int nGrow, int nrep)
+{
+    const int n = cells.size();
+    grids.resize(n);
+    const auto cells_ptr = cells.dataPtr();
+    auto grids_ptr = grids.dataPtr();
+
+    Gpu::synchronize();
+    Real t0 = amrex::second();
+    for (int rep = 0; rep < nrep; ++rep)
+    {
+        AMREX_FOR_1D ( n, i,
+        {
+            grids_ptr[i] = assign_grid(cells_ptr[i], nGrow);
+        });
+    }
+    Gpu::synchronize();
+    return (amrex::second() - t0) / nrep;
+}
+
+void testLocator ()
+{
+    BL_PROFILE("testLocator");
+    TestParams params;
+    get_test_params(params, "locator");
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[AMREX_SPACEDIM];
+    for (int i = 0; i < AMREX_SPACEDIM; i++)
+        is_per[i] = 1;
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    // boxes of two different sizes
+    BoxArray ba_uniform(domain);
+    ba_uniform.maxSize(params.max_grid_size);
+    BoxList bl;
+    for (int i = 0; i < ba_uniform.size(); ++i)
+    {
+        Box bx = ba_uniform[i];
+        if (i % 3 == 0 && bx.length(0) > 1) {
+            bl.push_back(bx.chop(0, bx.smallEnd(0) + bx.length(0)/2));
+        }
+        bl.push_back(bx);
+    }
+    BoxArray ba(bl);
+
+    // random cells, some of them just outside the domain
+    Gpu::HostVector<IntVect> host_cells(params.num_cells);
+    for (auto& iv : host_cells)
+    {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            iv[idim] = static_cast<int>(amrex::Random_int(params.size[idim]+2)) - 1;
+        }
+    }
+    Gpu::DeviceVector<IntVect> cells(params.num_cells);
+    Gpu::copy(Gpu::hostToDevice, host_cells.begin(), host_cells.end(), cells.begin());
+
+    ParticleLocator<DenseBins<Box> > bins_locator;
+    HashGridParticleLocator hash_locator;
+
+    Real t0 = amrex::second();
+    bins_locator.build(ba, geom);
+    Real t_build_bins = amrex::second() - t0;
+    t0 = amrex::second();
+    hash_locator.build(ba, geom);
+    Real t_build_hash = amrex::second() - t0;
+
+    for (int nGrow = 0; nGrow <= 1; ++nGrow)
+    {
+        Gpu::DeviceVector<int> bins_grids, hash_grids;
+        Real t_bins = locate(bins_locator.getGridAssignor(), cells, bins_grids, nGrow, params.nrep);
+        Real t_hash = locate(hash_locator.getGridAssignor(), cells, hash_grids, nGrow, params.nrep);
+
+        Gpu::HostVector<int> h_bins_grids(params.num_cells), h_hash_grids(params.num_cells);
+        Gpu::copy(Gpu::deviceToHost, bins_grids.begin(), bins_grids.end(), h_bins_grids.begin());
+        Gpu::copy(Gpu::deviceToHost, hash_grids.begin(), hash_grids.end(), h_hash_grids.begin());
+
+        for (int i = 0; i < params.num_cells; ++i)
+        {
+            const IntVect& iv = host_cells[i];
+            const int gid = h_hash_grids[i];
+            if (nGrow == 0) {
+                AMREX_ALWAYS_ASSERT(gid == h_bins_grids[i]);
+                AMREX_ALWAYS_ASSERT((gid >= 0) == domain.contains(iv));
+            } else {
+                // several grown boxes may contain the cell
+                AMREX_ALWAYS_ASSERT((gid >= 0) == (h_bins_grids[i] >= 0));
+            }
+            if (gid >= 0) AMREX_ALWAYS_ASSERT(amrex::grow(ba[gid], nGrow).contains(iv));
+        }
+
+        amrex::Print() << "nGrow = " << nGrow << ": locating " << params.num_cells
+                       << " cells took " << t_bins << " s with the bins and "
+                       << t_hash << " s with the hash grid \n";
+    }
+
+    amrex::Print() << "Building the locators took " << t_build_bins
+                   << " s with the bins and " << t_build_hash << " s with the hash grid \n";
+
+    // the multi-level locator only rebuilds the levels whose BoxArray changed
+    Vector<BoxArray> bas{ba, ba_uniform};
+    Vector<Geometry> geoms{geom, geom};
+    AmrHashGridParticleLocator amr_locator(bas, geoms);
+    AMREX_ALWAYS_ASSERT(amr_locator.isValid(bas));
+    bas[1] = BoxArray(domain);
+    AMREX_ALWAYS_ASSERT(! amr_locator.isValid(bas));
+    amr_locator.build(bas, geoms);
+    AMREX_ALWAYS_ASSERT(amr_locator.isValid(bas));
+
+    amrex::Print() << "pass \n";
+}
@@ -18,6 +18,67 @@ struct TestParams {
   bool verbose;
 };
 
+template <int order, class PC>
+void testShape (PC& pc, const Geometry& geom, const MultiFab& cic, Real total_mass, bool verbose)
+{
+  const int nc = 1 + BL_SPACEDIM;
+  const int ng = (order+1)/2;
+  MultiFab rho(pc.ParticleBoxArray(0), pc.ParticleDistributionMap(0), nc, ng);
+
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+
+  Real strt_time = amrex::second();
+  amrex::ParticleToMesh(pc, rho, 0,
+      [=] AMREX_GPU_DEVICE (const typename PC::ParticleType& p,
+                            amrex::Array4<amrex::Real> const& arr)
+      {
+          amrex_deposit_shape<order>(p, nc, arr, plo, dxi);
+      });
+  Real deposit_time = amrex::second() - strt_time;
+  ParallelDescriptor::ReduceRealMax(deposit_time);
+  if (verbose) {
+      amrex::Print() << "Order " << order << " deposit time : " << deposit_time << '\n';
+  }
+
+  // the shape functions conserve mass
+  const Real mass = rho.sum(0);
+  if (std::abs(mass - total_mass) > 1.e-10*total_mass) {
+      amrex::Abort("Shape function deposition does not conserve mass");
+  }
+
+  // order 1 is the cloud-in-cell deposition above
+  if (order == 1) {
+      MultiFab::Subtract(rho, cic, 0, 0, nc, 0);
+      for (int comp = 0; comp < nc; ++comp) {
+          if (rho.norm0(comp) > 1.e-12*amrex::max(cic.norm0(comp), Real(1.0))) {
+              amrex::Abort("Order 1 shape deposition does not match CIC");
+          }
+      }
+  }
+
+  // the shape functions are a partition of unity
+  MultiFab field(pc.ParticleBoxArray(0), pc.ParticleDistributionMap(0), BL_SPACEDIM, ng);
+  field.setVal(5.0);
+  int num_wrong = 0;
+  for (typename PC::ParConstIterType pti(pc, 0); pti.isValid(); ++pti)
+  {
+      const auto& aos = pti.GetArrayOfStructs();
+      const auto arr = field.const_array(pti);
+      for (const auto& p : aos()) {
+          Real val[BL_SPACEDIM];
+          amrex_interpolate_shape<order>(p, BL_SPACEDIM, arr, plo, dxi, val);
+          for (int comp = 0; comp < BL_SPACEDIM; ++comp) {
+              if (std::abs(val[comp] - 5.0) > 1.e-12) ++num_wrong;
+          }
+      }
+  }
+  ParallelDescriptor::ReduceIntSum(num_wrong);
+  if (num_wrong > 0) {
+      amrex::Abort("Shape function interpolation is not a partition of unity");
+  }
+}
+
 void testParticleMesh(TestParams& parms)
 {
 
@@ -66,9 +127,8 @@ void testParticleMesh(TestParams& parms)
   int nc = 1 + BL_SPACEDIM;
   const auto plo = geom.ProbLoArray();
   const auto dxi = geom.InvCellSizeArray();
-  amrex::ParticleToMesh(myPC, partMF, 0,
-      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
-                            amrex::Array4<amrex::Real> const& rho)
+  auto deposit = [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                                       amrex::Array4<amrex::Real> const& rho)
       {
           amrex::Real lx = (p.pos(0) - plo[0]) * dxi[0] + 0.5;
           amrex::Real ly = (p.pos(1) - plo[1]) * dxi[1] + 0.5;
@@ -105,7 +165,42 @@ void testParticleMesh(TestParams& parms)
                   }
               }
           }
-      });
+      };
+
+  // the colored deposition writes straight into the fabs, so it wants
+  // particles that are sorted in space
+  myPC.SortParticlesByMorton();
+
+  Real strt_time = amrex::second();
+  amrex::ParticleToMesh(myPC, partMF, 0, deposit);
+  Real tiled_time = amrex::second() - strt_time;
+
+  // the colored deposition must give the same answer
+  MultiFab partMF_colored(ba, dmap, 1 + BL_SPACEDIM, 1);
+  partMF_colored.setVal(0.0);
+  strt_time = amrex::second();
+  amrex::ParticleToMeshColored(myPC, partMF_colored, 0, deposit);
+  Real colored_time = amrex::second() - strt_time;
+
+  ParallelDescriptor::ReduceRealMax(tiled_time);
+  ParallelDescriptor::ReduceRealMax(colored_time);
+  if (parms.verbose) {
+      amrex::Print() << "ParticleToMesh time         : " << tiled_time << '\n'
+                     << "ParticleToMeshColored time  : " << colored_time << '\n';
+  }
+
+  MultiFab::Subtract(partMF_colored, partMF, 0, 0, 1 + BL_SPACEDIM, 0);
+  for (int comp = 0; comp < 1 + BL_SPACEDIM; ++comp) {
+      const Real scale = amrex::max(partMF.norm0(comp), Real(1.0));
+      if (partMF_colored.norm0(comp) > 1.e-12*scale) {
+          amrex::Abort("ParticleToMeshColored does not match ParticleToMesh");
+      }
+  }
+
+  const Real total_mass = mass*num_particles;
+  testShape<1>(myPC, geom, partMF, total_mass, parms.verbose);
+  testShape<2>(myPC, geom, partMF, total_mass, parms.verbose);
+  testShape<3>(myPC, geom, partMF, total_mass, parms.verbose);
 
   MultiFab acceleration(ba, dmap, BL_SPACEDIM, 1);
   acceleration.setVal(5.0);
@@ -0,0 +1,289 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+static constexpr int NSR = 0;
+static constexpr int NSI = 0;
+// the initial position and the id of each particle
+static constexpr int NAR = AMREX_SPACEDIM + 1;
+static constexpr int NAI = 1;
+
+// How many cells particle id moves in direction dir each step
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real displacement (int id, int dir)
+{
+    const Real sign = (id % 2 == 0) ? Real(1.0) : Real(-1.0);
+    return sign * (Real(0.61) + Real(0.37) * ((id + 3*dir) % 5));
+}
+
+void get_position_unit_cell(Real* r, const IntVect& nppc, int i_part)
+{
+    int nx = nppc[0];
+#if AMREX_SPACEDIM > 1
+    int ny = nppc[1];
+#else
+    int ny = 1;
+#endif
+#if AMREX_SPACEDIM > 2
+    int nz = nppc[2];
+#else
+    int nz = 1;
+#endif
+
+    int ix_part = i_part/(ny * nz);
+    int iy_part = (i_part % (ny * nz)) % ny;
+    int iz_part = (i_part % (ny * nz)) / ny;
+
+    r[0] = (0.5+ix_part)/nx;
+    r[1] = (0.5+iy_part)/ny;
+    r[2] = (0.5+iz_part)/nz;
+}
+
+class TestParticleContainer
+    : public amrex::ParticleContainer<NSR, NSI, NAR, NAI>
+{
+
+public:
+
+    TestParticleContainer (const amrex::Geometry            & a_geom,
+                           const amrex::DistributionMapping & a_dmap,
+                           const amrex::BoxArray            & a_ba)
+        : amrex::ParticleContainer<NSR, NSI, NAR, NAI>(a_geom, a_dmap, a_ba)
+    {
+        SetPureSoA(true);
+        // twice the id
+        AddRealComp(true);
+    }
+
+    void InitParticles (const amrex::IntVect& a_num_particles_per_cell)
+    {
+        BL_PROFILE("InitParticles");
+
+        const int lev = 0;
+        const Real* dx = Geom(lev).CellSize();
+        const Real* plo = Geom(lev).ProbLo();
+
+        const int num_ppc = AMREX_D_TERM( a_num_particles_per_cell[0],
+                                         *a_num_particles_per_cell[1],
+                                         *a_num_particles_per_cell[2]);
+
+        for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+        {
+            const Box& tile_box = mfi.tilebox();
+
+            Gpu::HostVector<ParticleType> host_particles;
+            std::array<Gpu::HostVector<ParticleReal>, NAR+1> host_real;
+            Gpu::HostVector<int> host_int;
+            for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv))
+            {
+                for (int i_part = 0; i_part < num_ppc; i_part++)
+                {
+                    Real r[3];
+                    get_position_unit_cell(r, a_num_particles_per_cell, i_part);
+
+                    ParticleType p;
+                    p.id()  = ParticleType::NextID();
+                    p.cpu() = ParallelDescriptor::MyProc();
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        p.pos(d) = plo[d] + (iv[d] + r[d])*dx[d];
+                        host_real[d].push_back(p.pos(d));
+                    }
+                    host_particles.push_back(p);
+
+                    host_real[AMREX_SPACEDIM].push_back(p.id());
+                    host_real[NAR].push_back(2*p.id());
+                    host_int.push_back(p.id());
+                }
+            }
+
+            auto& ptile = DefineAndReturnParticleTile(lev, mfi);
+            auto old_size = ptile.numParticles();
+            auto new_size = old_size + host_particles.size();
+            ptile.resize(new_size);
+
+            ptile.copyParticlesFromHost(host_particles.dataPtr(), host_particles.size(), old_size);
+
+            auto& soa = ptile.GetStructOfArrays();
+            for (int i = 0; i < NAR+1; ++i)
+            {
+                Gpu::copy(Gpu::hostToDevice, host_real[i].begin(), host_real[i].end(),
+                          soa.GetRealData(i).begin() + old_size);
+            }
+            Gpu::copy(Gpu::hostToDevice, host_int.begin(), host_int.end(),
+                      soa.GetIntData(0).begin() + old_size);
+            Gpu::streamSynchronize();
+        }
+    }
+
+    void moveParticles ()
+    {
+        BL_PROFILE("TestParticleContainer::moveParticles");
+
+        const auto dx = Geom(0).CellSizeArray();
+        for (ParIterType pti(*this, 0); pti.isValid(); ++pti)
+        {
+            const auto ptd = pti.GetParticleTile().getParticleTileData();
+            amrex::ParallelFor(pti.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                const int id = ptd.id(i);
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    ptd.pos(d, i) += displacement(id, d)*dx[d];
+                }
+            });
+        }
+    }
+
+    // After nsteps moves, particle id must be displaced by nsteps times its
+    // displacement from where it started, up to the periodic wrap
+    void checkAnswer (int nsteps) const
+    {
+        BL_PROFILE("TestParticleContainer::checkAnswer");
+
+        AMREX_ALWAYS_ASSERT(numParticlesOutOfRange(*this, 0) == 0);
+
+        const auto dx = Geom(0).CellSizeArray();
+        const auto plo = Geom(0).ProbLoArray();
+        const auto phi = Geom(0).ProbHiArray();
+
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<int> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        for (ParConstIterType pti(*this, 0); pti.isValid(); ++pti)
+        {
+            const auto& ptile = pti.GetParticleTile();
+            AMREX_ALWAYS_ASSERT(ptile.isPureSoA());
+            AMREX_ALWAYS_ASSERT(ptile.GetArrayOfStructs().numParticles() == 0);
+
+            const auto ptd = ptile.getConstParticleTileData();
+            reduce_op.eval(pti.numParticles(), reduce_data,
+            [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
+            {
+                const int id = ptd.id(i);
+                int nbad = 0;
+                if (ptd.m_rdata[AMREX_SPACEDIM][i] != id) ++nbad;
+                if (ptd.m_runtime_rdata[0][i] != 2*id) ++nbad;
+                if (ptd.m_idata[0][i] != id) ++nbad;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d)
+                {
+                    const Real len = phi[d] - plo[d];
+                    Real diff = ptd.pos(d, i) - ptd.m_rdata[d][i] - nsteps*displacement(id, d)*dx[d];
+                    diff -= len*std::round(diff/len);
+                    if (std::abs(diff) > Real(1.e-8)*len) ++nbad;
+                }
+                return nbad;
+            });
+        }
+
+        int nbad = amrex::get<0>(reduce_data.value());
+        ParallelAllReduce::Sum(nbad, ParallelContext::CommunicatorSub());
+        AMREX_ALWAYS_ASSERT(nbad == 0);
+    }
+};
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_ppc;
+    int nsteps;
+    int sort;
+};
+
+void testPureSoA();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running pure SoA particle test \n";
+    testPureSoA();
+
+    amrex::Finalize();
+}
+
+void get_test_params(TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+    pp.get("nsteps", params.nsteps);
+
+    params.sort = 0;
+    pp.query("sort", params.sort);
+}
+
+void testPureSoA ()
+{
+    BL_PROFILE("testPureSoA");
+    TestParams params;
+    get_test_params(params, "soa");
+
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++)
+        is_per[i] = 1;
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    TestParticleContainer pc(geom, dm, ba);
+
+    int npc = params.num_ppc;
+    IntVect nppc = IntVect(AMREX_D_DECL(npc, npc, npc));
+
+    amrex::Print() << "About to initialize particles \n";
+
+    pc.InitParticles(nppc);
+    pc.checkAnswer(0);
+
+    const Long np_old = pc.TotalNumberOfParticles();
+
+    for (int i = 0; i < params.nsteps; ++i)
+    {
+        pc.moveParticles();
+        pc.Redistribute();
+        if (params.sort) {
+            if (i % 2 == 0) {
+                pc.SortParticlesByCell();
+            } else {
+                pc.SortParticlesByMorton();
+            }
+        }
+        pc.checkAnswer(i+1);
+    }
+
+    AMREX_ALWAYS_ASSERT(np_old == pc.TotalNumberOfParticles());
+
+    // write the particles and read them back into another pure SoA container
+    pc.Checkpoint("chk_pure_soa", "particles");
+
+    TestParticleContainer pc2(geom, dm, ba);
+    pc2.Restart("chk_pure_soa", "particles");
+    AMREX_ALWAYS_ASSERT(pc2.TotalNumberOfParticles() == np_old);
+    pc2.checkAnswer(params.nsteps);
+
+    pc2.moveParticles();
+    pc2.Redistribute();
+    pc2.checkAnswer(params.nsteps+1);
+
+    // the way this test is set up, if we make it here we pass
+    amrex::Print() << "pass \n";
+}
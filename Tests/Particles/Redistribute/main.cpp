@@ -13,6 +13,14 @@ static constexpr int NAI = 1;
 int num_runtime_real = 0;
 int num_runtime_int = 0;
 
+// The runtime real components are zero for every third particle and
+// otherwise hold values that single precision cannot represent
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+ParticleReal runtime_real_value (int id)
+{
+    return (id % 3 == 0) ? ParticleReal(0.0) : ParticleReal(id) + ParticleReal(1.0)/ParticleReal(3.0);
+}
+
 void get_position_unit_cell(Real* r, const IntVect& nppc, int i_part)
 {
     int nx = nppc[0];
@@ -67,6 +75,15 @@ public:
         Redistribute(lev_min, lev_max, nGrow, local);
     }
 
+    void RedistributeMovedLocal ()
+    {
+        const int lev_min = 0;
+        const int lev_max = finestLevel();
+        const int nGrow = 0;
+        const int local = 1;
+        RedistributeMoved(lev_min, lev_max, nGrow, local);
+    }
+
     void RedistributeGlobal ()
     {
         const int lev_min = 0;
@@ -125,7 +142,7 @@ public:
                     for (int i = 0; i < NAI; ++i)
                         host_int[i].push_back(p.id());
                     for (int i = 0; i < NumRuntimeRealComps(); ++i)
-                        host_runtime_real[i].push_back(p.id());
+                        host_runtime_real[i].push_back(runtime_real_value(p.id()));
                     for (int i = 0; i < NumRuntimeIntComps(); ++i)
                         host_runtime_int[i].push_back(p.id());
                 }
@@ -179,7 +196,7 @@ public:
         RedistributeLocal();
     }
 
-    void moveParticles (const IntVect& move_dir, int do_random)
+    void moveParticles (const IntVect& move_dir, int do_random, int mark_moved = 0)
     {
         BL_PROFILE("TestParticleContainer::moveParticles");
 
@@ -227,6 +244,15 @@ public:
 #endif
                     });
                 }
+
+                if (mark_moved)
+                {
+                    const Box& tile_box = mfi.tilebox();
+                    for (int i = 0; i < static_cast<int>(np); ++i)
+                    {
+                        if (! tile_box.contains(Index(pstruct[i], lev))) ptile.markMoved(i);
+                    }
+                }
             }
         }
     }
@@ -239,6 +265,8 @@ public:
 
         int num_rr = NumRuntimeRealComps();
         int num_ii = NumRuntimeIntComps();
+        int float_comp = m_float_comp;
+        bool lossy = sizeof(ParticleReal) > sizeof(float);
 
         for (int lev = 0; lev <= finestLevel(); ++lev)
         {
@@ -271,7 +299,17 @@ public:
                     }
                     for (int j = 0; j < num_rr; ++j)
                     {
-                        AMREX_ALWAYS_ASSERT(ptd.m_runtime_rdata[j][i] == ptd.m_aos[i].id());
+                        const ParticleReal v = runtime_real_value(ptd.m_aos[i].id());
+                        if (j == float_comp) {
+                            // rounded once to single precision, and nonzero
+                            // values lose their last digits
+                            AMREX_ALWAYS_ASSERT(ptd.m_runtime_rdata[j][i] ==
+                                                static_cast<ParticleReal>(static_cast<float>(v)));
+                            AMREX_ALWAYS_ASSERT(v == ParticleReal(0.0) || !lossy ||
+                                                ptd.m_runtime_rdata[j][i] != v);
+                        } else {
+                            AMREX_ALWAYS_ASSERT(ptd.m_runtime_rdata[j][i] == v);
+                        }
                     }
                     for (int j = 0; j < num_ii; ++j)
                     {
@@ -281,8 +319,67 @@ public:
             }
         }
     }
+
+    //! The compacted components are read through ParIter without expanding them first
+    void checkCompactAccess ()
+    {
+        BL_PROFILE("TestParticleContainer::checkCompactAccess");
+
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            for (ParIter<NSR, NSI, NAR, NAI> pti(*this, lev); pti.isValid(); ++pti)
+            {
+                const auto& aos = pti.GetArrayOfStructs();
+                auto& soa = pti.GetStructOfArrays();
+                for (int j = 0; j < NumRuntimeRealComps(); ++j)
+                {
+                    AMREX_ALWAYS_ASSERT(soa.realDataStorage(NAR+j) == ParticleCompStorage::Dense);
+                }
+                if (NumRuntimeRealComps() == 0) continue;
+
+                Gpu::HostVector<ParticleType> host_aos(aos.size());
+                Gpu::HostVector<ParticleReal> host_real(aos.size());
+                Gpu::copy(Gpu::deviceToHost, aos.begin(), aos.end(), host_aos.begin());
+                Gpu::copy(Gpu::deviceToHost, soa.GetRealData(NAR).begin(),
+                          soa.GetRealData(NAR).end(), host_real.begin());
+                for (int i = 0; i < static_cast<int>(host_aos.size()); ++i)
+                {
+                    AMREX_ALWAYS_ASSERT(host_real[i] == runtime_real_value(host_aos[i].id()));
+                }
+            }
+        }
+    }
+
+    //! The runtime real component that has been through single precision
+    int m_float_comp = -1;
 };
 
+// The sparse component keeps the nonzero values only, the other one keeps
+// all of them in single precision
+void checkCompactStorage (const TestParticleContainer& pc)
+{
+    Long nzeros = 0;
+    for (int lev = 0; lev <= pc.finestLevel(); ++lev)
+    {
+        for (const auto& kv : pc.GetParticles(lev))
+        {
+            const auto& aos = kv.second.GetArrayOfStructs();
+            const auto& soa = kv.second.GetStructOfArrays();
+            std::size_t nnz = 0;
+            for (const auto& p : aos) {
+                if (p.id() % 3 != 0) ++nnz;
+            }
+            nzeros += soa.size() - nnz;
+            AMREX_ALWAYS_ASSERT(soa.realDataStorage(NAR) == ParticleCompStorage::Sparse);
+            AMREX_ALWAYS_ASSERT(soa.realDataBytes(NAR) == nnz*(sizeof(int)+sizeof(ParticleReal)));
+            AMREX_ALWAYS_ASSERT(soa.realDataStorage(NAR+1) == ParticleCompStorage::Float);
+            AMREX_ALWAYS_ASSERT(soa.realDataBytes(NAR+1) == soa.size()*sizeof(float));
+        }
+    }
+    ParallelAllReduce::Sum(nzeros, ParallelContext::CommunicatorSub());
+    AMREX_ALWAYS_ASSERT(nzeros > 0);
+}
+
 struct TestParams
 {
     IntVect size;
@@ -295,6 +392,10 @@ struct TestParams
     int nlevs;
     int do_regrid;
     int sort;
+    int lazy;
+    int compact;
+    int move_tiles;
+    int checkpoint;
 };
 
 void testRedistribute();
@@ -326,6 +427,18 @@ void get_test_params(TestParams& params, const std::string& prefix)
 
     params.sort = 0;
     pp.query("sort", params.sort);
+
+    params.lazy = 0;
+    pp.query("lazy", params.lazy);
+
+    params.compact = 0;
+    pp.query("compact", params.compact);
+
+    params.move_tiles = 0;
+    pp.query("move_tiles", params.move_tiles);
+
+    params.checkpoint = 0;
+    pp.query("checkpoint", params.checkpoint);
 }
 
 void testRedistribute ()
@@ -384,12 +497,32 @@ void testRedistribute ()
 
     pc.checkAnswer();
 
+    // store the first runtime real component sparsely and the second one
+    // in single precision.  They stay compact through the Redistributes
+    // and are expanded by whatever accesses them.
+    const bool compact = params.compact && num_runtime_real > 1;
+    if (compact)
+    {
+        pc.SetRealCompStorage(NAR, ParticleCompStorage::Sparse);
+        pc.SetRealCompStorage(NAR+1, ParticleCompStorage::Float);
+        pc.CompactRealComps();
+        pc.m_float_comp = 1;
+    }
+
     auto np_old = pc.TotalNumberOfParticles();
 
     for (int i = 0; i < params.nsteps; ++i)
     {
-        pc.moveParticles(params.move_dir, params.do_random);
-        pc.RedistributeLocal();
+        pc.moveParticles(params.move_dir, params.do_random, params.lazy);
+        if (params.lazy) {
+            pc.RedistributeMovedLocal();
+        } else {
+            pc.RedistributeLocal();
+        }
+        if (compact) {
+            checkCompactStorage(pc);
+            pc.checkCompactAccess();
+        }
         if (params.sort) pc.SortParticlesByCell();
         pc.checkAnswer();
     }
@@ -406,7 +539,13 @@ void testRedistribute ()
                 new_dm.define(pmap);
                 pc.SetParticleDistributionMap(lev, new_dm);
             }
-            pc.RedistributeGlobal();
+            if (compact) pc.CompactRealComps();
+            if (params.move_tiles) {
+                pc.RedistributeTiles();
+            } else {
+                pc.RedistributeGlobal();
+            }
+            if (compact) checkCompactStorage(pc);
             pc.checkAnswer();
         }
 
@@ -419,13 +558,45 @@ void testRedistribute ()
                 new_dm.define(pmap);
                 pc.SetParticleDistributionMap(lev, new_dm);
             }
-            pc.RedistributeGlobal();
+            if (compact) pc.CompactRealComps();
+            if (params.move_tiles) {
+                pc.RedistributeTiles();
+            } else {
+                pc.RedistributeGlobal();
+            }
+            if (compact) checkCompactStorage(pc);
             pc.checkAnswer();
         }
     }
 
     if (geom[0].isAllPeriodic()) AMREX_ALWAYS_ASSERT(np_old == pc.TotalNumberOfParticles());
 
+    // write the particles and read them back
+    if (params.checkpoint)
+    {
+        if (compact) {
+            pc.CompactRealComps();
+        }
+        pc.Checkpoint("chk_redistribute", "particles");
+
+        TestParticleContainer pc2(geom, dm, ba, rr);
+        pc2.Restart("chk_redistribute", "particles");
+        pc2.m_float_comp = pc.m_float_comp;
+        pc2.checkAnswer();
+        AMREX_ALWAYS_ASSERT(pc2.TotalNumberOfParticles() == pc.TotalNumberOfParticles());
+
+        using PType = typename TestParticleContainer::SuperParticleType;
+        auto sum_pos = [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> ParticleReal
+        {
+            return AMREX_D_TERM(p.pos(0), + p.pos(1), + p.pos(2));
+        };
+        ParticleReal s1 = amrex::ReduceSum(pc, sum_pos);
+        ParticleReal s2 = amrex::ReduceSum(pc2, sum_pos);
+        ParallelAllReduce::Sum(s1, ParallelContext::CommunicatorSub());
+        ParallelAllReduce::Sum(s2, ParallelContext::CommunicatorSub());
+        AMREX_ALWAYS_ASSERT(std::abs(s1-s2) <= 1.e-10*std::abs(s1));
+    }
+
     // the way this test is set up, if we make it here we pass
     amrex::Print() << "pass \n";
 }
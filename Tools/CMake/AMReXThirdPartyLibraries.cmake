@@ -69,3 +69,12 @@ if (AMReX_PETSC)
     find_package(PETSc 2.13 REQUIRED)
     target_link_libraries( amrex PUBLIC PETSC )
 endif ()
+
+
+#
+# FFTW for SWFFT
+#
+if (AMReX_SWFFT)
+    find_package(FFTW REQUIRED)
+    target_link_libraries( amrex PUBLIC FFTW )
+endif ()